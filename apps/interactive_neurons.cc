@@ -11,6 +11,7 @@
 #include "imgui_adapter/node-adapter.h"
 #include "mnist-utilities.h"
 #include "neurons/network-container.h"
+#include "neurons/network-spec.h"
 #include "node_creator.h"
 
 namespace neurons {
@@ -27,20 +28,67 @@ InteractiveNeurons::InteractiveNeurons() {
   network_ = Network();
   freeze_editor_ = false;
   training_ = false;
+  startup_progress_ = 0;
+}
 
-  dim_t kBatchSize = 64;
-  spawner::SpawnMnistDataNode(network_, kDataDirectory, kBatchSize);
+// Initializes the ArrayFire and flashlight backends, which otherwise happens
+// on first use, then loads the MNIST splits. Updates progress as it goes.
+mnist_utilities::MnistSplits LoadStartupData(const std::string& data_directory,
+    std::atomic<float>& progress) {
+  // a small forward pass initializes the device and compiles the first
+  // kernels
+  fl::Linear warm_up(4, 4);
+  warm_up(fl::noGrad(af::randu(4, 1))).array().eval();
+  af::sync();
+  progress = 0.5f;
+
+  auto splits = mnist_utilities::load_splits(data_directory);
+  af::sync();
+  progress = 1.0f;
+  return splits;
 }
 
 void InteractiveNeurons::setup() {
   ImGui::Initialize(ImGui::Options());
   imnodes::Initialize();
+
+  // show the window first, and load the data while it is drawn
+  startup_result_ = std::async(std::launch::async, LoadStartupData,
+      kDataDirectory, std::ref(startup_progress_));
 }
 
-void InteractiveNeurons::update() { }
+void InteractiveNeurons::update() {
+  if (!startup_result_.valid() ||
+      startup_result_.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready) {
+    return;
+  }
+
+  dim_t kBatchSize = 64;
+  size_t kPrefetchThreads = 2;
+  size_t kPrefetchDepth = 4;
+  try {
+    // the Network is only modified on the main thread
+    spawner::SpawnMnistDataNode(network_, startup_result_.get(), kBatchSize,
+                                kPrefetchThreads, kPrefetchDepth);
+  } catch (const std::exception& exception) {
+    log_ << "Failed to load MNIST: " << exception.what() << std::endl;
+  }
+}
+
+// Draws the startup progress until the data has loaded.
+void DrawStartupProgress(float progress) {
+  ImGui::Begin("Loading");
+  ImGui::Text("%s", progress < 0.5f ? "Initializing backend..."
+                                    : "Loading MNIST...");
+  ImGui::ProgressBar(progress);
+  ImGui::End();
+}
 
 // Draw all the nodes on the imnodes NodeEditor.
-void DrawNodes(const std::vector<NodeAdapter>& nodes) {
+// If the network is disconnected, labels every node with its component.
+void DrawNodes(const std::vector<NodeAdapter>& nodes, const Network& network) {
+  const bool disconnected = network.CountComponents() > 1;
   for (const NodeAdapter& node : nodes) {
     imnodes::BeginNode(node.id_);
 
@@ -49,6 +97,11 @@ void DrawNodes(const std::vector<NodeAdapter>& nodes) {
     ImGui::TextWrapped("%s", node.node_->prettyString().c_str());
     imnodes::EndNodeTitleBar();
 
+    if (disconnected) {
+      ImGui::Text("Island %zu",
+                  network.GetComponentId(node.node_->GetId()));
+    }
+
     NodeType type = node.node_->GetNodeType();
 
     // data nodes should not have an input pin
@@ -72,9 +125,10 @@ void DrawNodes(const std::vector<NodeAdapter>& nodes) {
 }
 
 // Attempt to create a link between Nodes on the Network.
+// Logs the reason if the Network rejects the link.
 void AttemptLink(std::vector<NodeAdapter>& nodes,
     std::vector<LinkAdapter>& links, Network& network,
-    size_t start_id, size_t end_id) {
+    size_t start_id, size_t end_id, std::ostream& log) {
 
   NodeAdapter* start = adapter::FindPinOwner(nodes, start_id);
   NodeAdapter* end = adapter::FindPinOwner(nodes, end_id);
@@ -98,11 +152,14 @@ void AttemptLink(std::vector<NodeAdapter>& nodes,
   }
 
   // attempt to add link
-  network.AddLink(start->node_, end->node_);
+  LinkRejection rejection;
+  if (network.AddLink(start->node_, end->node_, rejection) == nullptr) {
+    log << LinkRejectionToString(rejection) << std::endl;
+  }
 }
 
 // Handle Link deletion
-void HandleLinkDeletion(std::vector<LinkAdapter>& links, Network& network) {
+void HandleLinkDeletion(Network& network) {
   // See if any links are selected
   const size_t num_links_selected = imnodes::NumSelectedLinks();
 
@@ -110,23 +167,22 @@ void HandleLinkDeletion(std::vector<LinkAdapter>& links, Network& network) {
       ImGui::IsKeyReleased(ImGui::GetIO().KeyMap[ImGuiKey_Backspace])) {
     std::vector<int> selected_links;
     selected_links.resize(num_links_selected);
-    // Load selected_nodes with IDs of selected nodes
+    // Load selected_links with IDs of selected links
     imnodes::GetSelectedLinks(selected_links.data());
-    while(!selected_links.empty()) {
-      auto adapter = neurons::adapter::FindOwnerLink(links,
-          selected_links.back());
-      selected_links.pop_back();
-      // could occur if user selects node and then presses delete twice
-      if (adapter == nullptr) {
-        continue;
-      }
-      network.DeleteLink(*adapter->link_);
+
+    // adapter IDs are link IDs multiplied by kIdMultiplier
+    // links that were already deleted are ignored by the network
+    std::vector<size_t> link_ids;
+    for (int selected : selected_links) {
+      link_ids.push_back(static_cast<size_t>(selected) /
+                         adapter::kIdMultiplier);
     }
+    network.DeleteLinks(link_ids);
   }
 }
 
 // Handle Node deletion
-void HandleNodeDeletion(std::vector<NodeAdapter>& nodes, Network& network) {
+void HandleNodeDeletion(Network& network) {
   // See if any nodes are selected
   const size_t num_nodes_selected = imnodes::NumSelectedNodes();
 
@@ -136,17 +192,21 @@ void HandleNodeDeletion(std::vector<NodeAdapter>& nodes, Network& network) {
     selected_nodes.resize(num_nodes_selected);
     // Load selected_nodes with IDs of selected nodes
     imnodes::GetSelectedNodes(selected_nodes.data());
-    while(!selected_nodes.empty()) {
-      auto adapter = neurons::adapter::FindOwnerNode(nodes,
-          selected_nodes.back());
-      selected_nodes.pop_back();
+
+    // adapter IDs are node IDs multiplied by kIdMultiplier
+    std::vector<size_t> node_ids;
+    for (int selected : selected_nodes) {
+      auto node = network.GetNode(static_cast<size_t>(selected) /
+                                  adapter::kIdMultiplier);
       // nullptr could occur if user selects node and then presses delete twice
       // do not allow deletion of Dataset node either
-      if (adapter == nullptr || adapter->node_->GetNodeType() == Dataset) {
+      if (node == nullptr || node->GetNodeType() == Dataset) {
         continue;
       }
-      network.DeleteNode(*adapter->node_);
+      node_ids.push_back(node->GetId());
     }
+    // deletes every selected node in a single pass over the network
+    network.DeleteNodes(node_ids);
   }
 }
 
@@ -220,12 +280,14 @@ void HandleNodeCreation(Network& network, bool& freeze_editor) {
   }
 }
 
-// Modifies the passed shared_ptr<fl::FirstOrderOptimizer> and epochs
-// with the configuration. Returns true if modification successful.
-// Prints any errors/exceptions to output.
+// Modifies the passed shared_ptr<fl::FirstOrderOptimizer>, epochs, split,
+// batch sizes, augmentation and loss readback interval with the
+// configuration. Returns true if
+// modification successful. Prints any errors/exceptions to output.
 bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
     bool& freeze_editor, std::shared_ptr<fl::FirstOrderOptimizer>& optim,
-    int& epochs) {
+    int& epochs, float& valid_fraction, int& batch_size,
+    int& eval_batch_size, bool& augment, int& readback_interval) {
 
   freeze_editor = true;
   ImGui::OpenPopup("Train Model");
@@ -237,6 +299,32 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
     ImGui::Text("Training Epochs:");
     ImGui::InputInt("##Epochs", &config_epochs);
 
+    // fraction of the train examples held out for validation
+    static float config_valid_fraction =
+        static_cast<float>(mnist_utilities::kValSize) /
+        mnist_utilities::kTrainSize;
+    ImGui::Text("Validation Split:");
+    ImGui::InputFloat("##Validation Split", &config_valid_fraction);
+
+    // validation and test sets are batched separately from the train set
+    static int config_batch_size = 64;
+    static int config_eval_batch_size = 1024;
+    ImGui::Text("Batch Size:");
+    ImGui::InputInt("##Batch Size", &config_batch_size);
+    ImGui::Text("Evaluation Batch Size:");
+    ImGui::InputInt("##Evaluation Batch Size", &config_eval_batch_size);
+
+    // randomly distort the train images, which slows overfitting
+    static bool config_augment = false;
+    ImGui::Checkbox("Augment Train Set", &config_augment);
+
+    // batches between reads of the train loss, which wait for the device;
+    // 0 reads it once per epoch
+    static int config_readback_interval =
+        mnist_utilities::kLossReadbackInterval;
+    ImGui::Text("Loss Readback Interval:");
+    ImGui::InputInt("##Loss Readback Interval", &config_readback_interval);
+
     static std::string optimizer_str;
     std::string optim_options[] = {"AdadeltaOptimizer", "AdagradOptimizer",
                                 "AdamOptimizer", "AMSgradOptimizer",
@@ -262,7 +350,9 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
 
     static std::shared_ptr<fl::FirstOrderOptimizer> optimizer;
 
-    static bool optim_valid = false;
+    bool optim_valid = false;
+    // arguments of the selected optimizer, in the order of network specs
+    std::vector<double> optim_args;
 
     // Load rest of required arguments based on selected optimizer
     if (optimizer_str == "AdadeltaOptimizer" ||
@@ -277,19 +367,7 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
         ImGui::InputFloat(label.c_str(), &args[i]);
       }
 
-      optim_valid = args[0] > 0 && args[1] > 0 && args[2] > 0 && args[3] >= 0;
-
-      if (optim_valid) {
-        if (optimizer_str == "AdadeltaOptimizer") {
-          optimizer = std::make_shared<fl::AdadeltaOptimizer>(
-              fl::AdadeltaOptimizer(container->params(),
-                  args[0], args[1], args[2], args[3]));
-        } else {
-          optimizer = std::make_shared<fl::RMSPropOptimizer>(
-              fl::RMSPropOptimizer(container->params(),
-                  args[0], args[1], args[2], args[3]));
-        }
-      }
+      optim_args.assign(args, args + 4);
     }
 
     if (optimizer_str == "AdagradOptimizer") {
@@ -303,13 +381,7 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
         ImGui::InputFloat(label.c_str(), &args[i]);
       }
 
-      optim_valid = args[0] > 0 && args[1] > 0 && args[2] >= 0;
-
-      if (optim_valid) {
-        optimizer = std::make_shared<fl::AdagradOptimizer>(
-            fl::AdagradOptimizer(container->params(),
-                args[0], args[1], args[2]));
-      }
+      optim_args.assign(args, args + 3);
     }
 
     if (optimizer_str == "AdamOptimizer" ||
@@ -325,25 +397,7 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
         ImGui::InputFloat(label.c_str(), &args[i]);
       }
 
-      optim_valid = args[0] > 0 && args[1] > 0 && args[2] > 0 && args[3] > 0 &&
-          args[4] >= 0;
-
-      if (optim_valid) {
-        if (optimizer_str == "AdamOptimizer") {
-          optimizer = std::make_shared<fl::AdamOptimizer>(
-              fl::AdamOptimizer(container->params(),args[0],
-                  args[1], args[2], args[3], args[4]));
-        } else if (optimizer_str == "AMSgradOptimizer") {
-          optimizer = std::make_shared<fl::AMSgradOptimizer>(
-              fl::AMSgradOptimizer(container->params(),args[0],
-                  args[1], args[2], args[3], args[4]));
-        } else {
-          optimizer = std::make_shared<fl::NovogradOptimizer>(
-              fl::NovogradOptimizer(container->params(),args[0],
-                  args[1], args[2], args[3], args[4]));
-
-        }
-      }
+      optim_args.assign(args, args + 5);
     }
 
     if (optimizer_str == "SGDOptimizer") {
@@ -361,12 +415,19 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
       ImGui::Text("%s", labels[3].c_str());
       ImGui::Checkbox(("##" + labels[3]).c_str(), &use_nesterov);
 
-      optim_valid = args[0] > 0 && args[1] > 0 && args[2] >= 0;
+      optim_args.assign(args, args + 3);
+      optim_args.push_back(use_nesterov ? 1 : 0);
+    }
 
-      if (optim_valid) {
-        optimizer = std::make_shared<fl::SGDOptimizer>(
-            fl::SGDOptimizer(container->params(),args[0],
-                args[1], args[2], use_nesterov));
+    // made by the same factory as the optimizers of network specs, which
+    // also checks the arguments
+    if (!optimizer_str.empty()) {
+      try {
+        optimizer = MakeOptimizer({optimizer_str, optim_args},
+                                  container->params());
+        optim_valid = true;
+      } catch (const std::invalid_argument&) {
+        // the dialog stays open until the arguments are valid
       }
     }
 
@@ -378,12 +439,19 @@ bool GetTrainConfiguration(std::shared_ptr<NetworkContainer>& container,
     }
 
     if (ImGui::Button("Train")) {
-      if (optim_valid && config_epochs > 0) {
+      if (optim_valid && config_epochs > 0 && config_valid_fraction >= 0 &&
+          config_valid_fraction < 1 && config_batch_size > 0 &&
+          config_eval_batch_size > 0 && config_readback_interval >= 0) {
         ImGui::CloseCurrentPopup();
         freeze_editor = false;
 
         // set the values for caller to have access
         epochs = config_epochs;
+        valid_fraction = config_valid_fraction;
+        batch_size = config_batch_size;
+        eval_batch_size = config_eval_batch_size;
+        augment = config_augment;
+        readback_interval = config_readback_interval;
         optim = optimizer;
 
         configured = true;
@@ -417,11 +485,13 @@ void InteractiveNeurons::draw() {
   imnodes::BeginNodeEditor();
 
   // Draw nodes
+  // adapters copy what they need from the views, which the edits below
+  // invalidate
   auto nodes = adapter::BuildNodeAdapters(network_.GetNodes());
-  DrawNodes(nodes);
+  DrawNodes(nodes, network_);
 
   // Draw Links
-  auto links = adapter::BuildLinkAdapters(network_.GetLinks());
+  auto links = adapter::BuildLinkAdapters(network_);
   for (const LinkAdapter& link : links) {
     imnodes::Link(link.id_, link.start_id_, link.end_id_);
   }
@@ -433,12 +503,14 @@ void InteractiveNeurons::draw() {
 
   if (ImGui::BeginMenuBar()) {
     if (ImGui::BeginMenu("Model Actions")) {
+      // training needs the data, which is loaded in the background
+      bool data_ready = network_.GetDataNode() != nullptr;
       if (!training_ && !freeze_editor_ && exception_ptr == nullptr &&
-          ImGui::MenuItem("Train Model")) {
+          ImGui::MenuItem("Train Model", nullptr, false, data_ready)) {
         // this block will throw exceptions if model is invalid architecture
         try {
           container = std::make_shared<NetworkContainer>(
-              NetworkContainer(network_.GetNodes(), network_.GetLinks()));
+              *network_.GetSnapshot());
         } catch (std::exception& exception) {
           exception_ptr = std::current_exception();
         }
@@ -453,29 +525,54 @@ void InteractiveNeurons::draw() {
 
   if (!training_ && container != nullptr && exception_ptr == nullptr) {
     int epochs;
+    float valid_fraction;
+    int batch_size;
+    int eval_batch_size;
+    bool augment;
+    int readback_interval;
     std::shared_ptr<fl::FirstOrderOptimizer> optim;
-    if (GetTrainConfiguration(container, freeze_editor_, optim, epochs)) {
-      // use multi-threading to allow Cinder to run while training
-      // train_model has a void return type, but store value so that
-      // it operates as an asynchronous thread otherwise it will block main
-      train_result_ =
-          std::async(std::launch::async, mnist_utilities::train_model,
-              std::ref(*container), std::ref(*network_.GetDataNode()),
-              std::ref(*optim), epochs, std::ref(log_),
-              std::ref(training_), std::ref(exception_ptr));
+    if (GetTrainConfiguration(container, freeze_editor_, optim, epochs,
+                              valid_fraction, batch_size, eval_batch_size,
+                              augment, readback_interval)) {
+      // re-split and re-batch the loaded examples, nothing is reloaded
+      auto data_node = network_.GetDataNode();
+      if (!data_node->SetValidationSplit(valid_fraction)) {
+        log_ << "Training not started: the loaded data cannot be re-split."
+             << std::endl;
+        container = nullptr;
+      } else if (!data_node->SetBatchSizes(batch_size, eval_batch_size)) {
+        log_ << "Training not started: the loaded data cannot be re-batched."
+             << std::endl;
+        container = nullptr;
+      } else if (!data_node->SetAugmentation(augment)) {
+        log_ << "Training not started: the loaded data cannot be augmented."
+             << std::endl;
+        container = nullptr;
+      } else {
+        // use multi-threading to allow Cinder to run while training
+        // train_model has a void return type, but store value so that
+        // it operates as an asynchronous thread otherwise it will block main
+        train_result_ =
+            std::async(std::launch::async, mnist_utilities::train_model,
+                std::ref(*container), std::ref(*network_.GetDataNode()),
+                std::ref(*optim), epochs, readback_interval, std::ref(log_),
+                std::ref(training_), std::ref(exception_ptr),
+                mnist_utilities::TrainCallbacks());
+      }
     }
   }
 
   if (!freeze_editor_ && !training_) {
-    HandleNodeDeletion(nodes, network_);
-    HandleLinkDeletion(links, network_);
-
-    // See if any links were drawn
+    // See if any links were drawn, before deletions leave the adapters
+    // pointing at nodes that are no longer in the network
     int start_pin;
     int end_pin;
     if (imnodes::IsLinkCreated(&start_pin, &end_pin)) {
-      AttemptLink(nodes, links, network_, start_pin, end_pin);
+      AttemptLink(nodes, links, network_, start_pin, end_pin, log_);
     }
+
+    HandleNodeDeletion(network_);
+    HandleLinkDeletion(network_);
   }
 
   ImGui::End();
@@ -494,6 +591,10 @@ void InteractiveNeurons::draw() {
   }
 
   DrawLog(log_);
+
+  if (startup_result_.valid()) {
+    DrawStartupProgress(startup_progress_);
+  }
 }
 
 void InteractiveNeurons::quit() {
@@ -3,12 +3,15 @@
 #ifndef FINALPROJECT_APPS_INTERACTIVE_NEURONS_H_
 #define FINALPROJECT_APPS_INTERACTIVE_NEURONS_H_
 
+#include <atomic>
 #include <cinder/app/App.h>
 #include <future>
 #include <imgui_adapter/link-adapter.h>
 #include <imgui_adapter/node-adapter.h>
 #include <neurons/network.h>
 
+#include "mnist-utilities.h"
+
 namespace neurons {
 
 class InteractiveNeurons : public cinder::app::App {
@@ -31,6 +34,10 @@ class InteractiveNeurons : public cinder::app::App {
   std::stringstream log_;
   // Training exception pointer
   std::exception_ptr exception_ptr;
+  // Progress of loading the data and warming up the backend, in [0, 1]
+  std::atomic<float> startup_progress_;
+  // Background startup task, which yields the loaded MNIST splits
+  std::future<mnist_utilities::MnistSplits> startup_result_;
   const std::string kDataDirectory = getAssetPath("mnist");
 };
 
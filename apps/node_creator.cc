@@ -2,6 +2,7 @@
 
 #include <cinder/CinderImGui.h>
 #include <imnodes.h>
+#include <neurons/network-spec.h>
 
 #include "mnist-utilities.h"
 #include "node_creator.h"
@@ -11,111 +12,23 @@ using neurons::Node;
 namespace neurons::spawner {
 
 bool SpawnMnistDataNode(neurons::Network& network,
-    const std::string& data_directory, dim_t batch_size) {
-  // Initialize DataNode of the Network
-  af::array train_x;
-  af::array train_y;
-  af::array test_x;
-  af::array test_y;
-  // train_x and train_y are passed as references
-  std::tie(train_x, train_y) =
-      mnist_utilities::load_dataset(data_directory, false);
-  std::tie(test_x, test_y) =
-      mnist_utilities::load_dataset(data_directory,true);
-
-  // Hold out the validation sets
-
-  auto valid_x = train_x(af::span, af::span, 0,
-      af::seq(0, mnist_utilities::kValSize - 1));
-  train_x = train_x(af::span, af::span, 0,
-      af::seq(mnist_utilities::kValSize, mnist_utilities::kTrainSize - 1));
-  auto valid_y = train_y(
-      af::seq(0, mnist_utilities::kValSize - 1));
-  train_y = train_y(
-      af::seq(mnist_utilities::kValSize,mnist_utilities::kTrainSize - 1));
-
-  // Make the BatchDatasets
-  auto train_set = fl::BatchDataset(std::make_shared<fl::TensorDataset>(
-      std::vector<af::array>{train_x, train_y}), batch_size);
-  auto valid_set = fl::BatchDataset(std::make_shared<fl::TensorDataset>(
-      std::vector<af::array>{valid_x, valid_y}), batch_size);
-  auto test_set = fl::BatchDataset(std::make_shared<fl::TensorDataset>(
-      std::vector<af::array>{test_x, test_y}), batch_size);
-
-  network.AddNode(std::make_unique<fl::BatchDataset>(train_set),
-                  std::make_unique<fl::BatchDataset>(valid_set),
-                  std::make_unique<fl::BatchDataset>(test_set));
+    const mnist_utilities::MnistSplits& splits, dim_t batch_size,
+    size_t prefetch_threads, size_t prefetch_depth) {
+  mnist_utilities::add_data_node(network, splits, batch_size,
+                                 prefetch_threads, prefetch_depth);
   return true;
 }
 
-// Spawn an Activation Node of the passed NodeType. If type does not
-// correspond to a valid activation node type, do nothing. Returns true
-// if successful.
-bool SpawnActivationNode(neurons::Network& network, neurons::NodeType type) {
-  std::unique_ptr<fl::Module> module;
-  switch (type) {
-    case Sigmoid:
-      module = std::make_unique<fl::Sigmoid>(fl::Sigmoid());
-      break;
-    case Tanh:
-      module = std::make_unique<fl::Tanh>(fl::Tanh());
-      break;
-    case HardTanh:
-      module = std::make_unique<fl::HardTanh>(fl::HardTanh());
-      break;
-    case ReLU:
-      module = std::make_unique<fl::ReLU>(fl::ReLU());
-      break;
-    case LeakyReLU:
-      module = std::make_unique<fl::LeakyReLU>(fl::LeakyReLU());
-      break;
-    case ELU:
-      module = std::make_unique<fl::ELU>(fl::ELU());
-      break;
-    case ThresholdReLU:
-      module = std::make_unique<fl::ThresholdReLU>(fl::ThresholdReLU());
-      break;
-    case GatedLinearUnit:
-      module = std::make_unique<fl::GatedLinearUnit>(fl::GatedLinearUnit());
-      break;
-    case LogSoftmax:
-      module = std::make_unique<fl::LogSoftmax>(fl::LogSoftmax());
-      break;
-    case Log:
-      module = std::make_unique<fl::Log>(fl::Log());
-      break;
-    default:
-      // if no activation node is selected
-      return false;
+// Add a Node of the passed NodeType whose module is made from args by
+// MakeModule, the factory network specs are built with. Returns false,
+// adding nothing, if the arguments are invalid for the type.
+bool AddModuleNode(neurons::Network& network, neurons::NodeType type,
+    const std::vector<double>& args) {
+  try {
+    network.AddNode(type, MakeModule(type, args));
+  } catch (const std::invalid_argument&) {
+    return false;
   }
-
-  network.AddNode(type, std::move(module));
-  return true;
-}
-
-// Spawn an Loss Node of the passed NodeType. If type does not
-// correspond to a valid loss node type, do nothing. Returns true
-// if successful.
-bool SpawnLossNode(neurons::Network& network, neurons::NodeType type) {
-  std::unique_ptr<fl::BinaryModule> module;
-
-  switch (type) {
-    case CategoricalCrossEntropy:
-      module = std::make_unique<fl::CategoricalCrossEntropy>(
-          fl::CategoricalCrossEntropy());
-      break;
-    case MeanAbsoluteError:
-      module = std::make_unique<fl::MeanAbsoluteError>(fl::MeanAbsoluteError());
-      break;
-    case MeanSquaredError:
-      module = std::make_unique<fl::MeanSquaredError>(fl::MeanSquaredError());
-      break;
-    default:
-      // if no loss node is selected
-      return false;
-  }
-
-  network.AddNode(type, std::move(module));
   return true;
 }
 
@@ -155,12 +68,10 @@ bool SpawnBatchNormNode(neurons::Network& network, bool& freeze_editor) {
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
       // arguments valid if Feature Axis >= 0 and Feature Size > 0
-      bool args_valid = (int_args[0] >= 0 && int_args[1] > 0);
-
-      if (args_valid) {
-        network.AddNode(BatchNorm, std::make_unique<fl::BatchNorm>(
-            fl::BatchNorm(int_args[0], int_args[1], double_args[0],
-                          double_args[1], bool_args[0], bool_args[1])));
+      if (AddModuleNode(network, BatchNorm,
+          {static_cast<double>(int_args[0]), static_cast<double>(int_args[1]),
+           double_args[0], double_args[1], bool_args[0] ? 1.0 : 0.0,
+           bool_args[1] ? 1.0 : 0.0})) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -202,11 +113,8 @@ bool SpawnLayerNormNode(neurons::Network& network, bool& freeze_editor) {
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
       // arguments valid if Feature Axis >= 0
-      bool args_valid = (axis >= 0);
-
-      if (args_valid) {
-        network.AddNode(LayerNorm, std::make_unique<fl::LayerNorm>(
-            fl::LayerNorm(axis, epsilon, affine, fl::kLnVariableAxisSize)));
+      if (AddModuleNode(network, LayerNorm,
+          {static_cast<double>(axis), epsilon, affine ? 1.0 : 0.0})) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -239,12 +147,8 @@ bool SpawnDropoutNode(neurons::Network& network, bool& freeze_editor) {
 
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
-      // Check that arguments are valid
-      bool args_valid = (ratio >= 0 && ratio < 1);
-
-      if (args_valid) {
-        network.AddNode(Dropout,std::make_unique<fl::Dropout>(
-            fl::Dropout(ratio)));
+      // arguments valid if the ratio is in [0, 1)
+      if (AddModuleNode(network, Dropout, {ratio})) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -279,28 +183,10 @@ bool SpawnViewNode(neurons::Network& network, bool& freeze_editor) {
 
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
-      // Check that arguments are valid
-      bool args_valid = true;
-
-      // View must have either nonnegative or -1 arguments
-      size_t num_negative_one = 0;
-      for (int dim : dims) {
-        if (dim == -1) {
-          ++num_negative_one;
-        } else if (dim < 0) {
-          args_valid = false;
-        }
-      }
-
-      // View can only have one -1 argument
-      if (num_negative_one > 1) {
-        args_valid = false;
-      }
-
-      if (args_valid) {
-        network.AddNode(View, std::make_unique<fl::View>(
-            fl::View(af::dim4(
-                dims[0], dims[1], dims[2], dims[3]))));
+      // View must have either nonnegative or -1 arguments, and can only
+      // have one -1 argument
+      if (AddModuleNode(network, View,
+          std::vector<double>(dims, dims + 4))) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -343,22 +229,12 @@ bool SpawnConv2DNode(neurons::Network& network, bool& freeze_editor) {
 
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
-      // Check that arguments are valid
-      bool args_valid = true;
-      for (size_t i = 0; i < 10; ++i) {
-        // zero-padding can be >= -1, everything else must be positive.
-        // zero-padding of -1 uses smallest possible padding such that
-        // out_size = ceil(in_size / stride)
-        if (!(n_args[i] > 0 || ((i == 6 || i == 7) && n_args[i] >= -1))) {
-          args_valid = false;
-        }
-      }
-
-      if (args_valid) {
-        network.AddNode(Conv2D,std::make_unique<fl::Conv2D>(
-            fl::Conv2D(n_args[0], n_args[1], n_args[2],
-                       n_args[3],n_args[4], n_args[5], n_args[6],
-                       n_args[7], n_args[8],n_args[9], bias)));
+      // zero-padding can be >= -1, everything else must be positive.
+      // zero-padding of -1 uses smallest possible padding such that
+      // out_size = ceil(in_size / stride)
+      std::vector<double> args(n_args, n_args + 10);
+      args.push_back(bias ? 1 : 0);
+      if (AddModuleNode(network, Conv2D, args)) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -411,14 +287,13 @@ bool SpawnPool2DNode(neurons::Network& network, bool& freeze_editor) {
       ImGui::EndCombo();
     }
 
-    // translate pooling_mode string into PoolingMode
-    fl::PoolingMode pooling;
-    if (pooling_mode == "MAX") {
-      pooling = fl::PoolingMode::MAX;
-    } else if (pooling_mode == "AVG_INCLUDE_POOLING") {
-      pooling = fl::PoolingMode::AVG_INCLUDE_PADDING;
-    } else {
-      pooling = fl::PoolingMode::AVG_EXCLUDE_PADDING;
+    // translate pooling_mode string into its index in modes, which is
+    // the pooling mode argument of MakeModule
+    int pooling = 2;
+    if (pooling_mode == modes[0]) {
+      pooling = 0;
+    } else if (pooling_mode == modes[1]) {
+      pooling = 1;
     }
 
     if (ImGui::Button("Cancel")) {
@@ -428,17 +303,12 @@ bool SpawnPool2DNode(neurons::Network& network, bool& freeze_editor) {
 
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
-      // Check that arguments are valid
       // All fields must be greater than 0, except padding which must be >= -1
       // zero-padding of -1 uses smallest possible padding such that
       // out_size = ceil(in_size / stride)
-      bool args_valid = n_args[0] > 0 && n_args[1] > 0 && n_args[2] > 0 &&
-                        n_args[3] > 0 && n_args[4] >= -1 && n_args[5] >= -1;
-
-      if (args_valid) {
-        network.AddNode(Pool2D, std::make_unique<fl::Pool2D>(
-            fl::Pool2D(n_args[0], n_args[1], n_args[2],
-                       n_args[3],n_args[4], n_args[5], pooling)));
+      std::vector<double> args(n_args, n_args + 6);
+      args.push_back(pooling);
+      if (AddModuleNode(network, Pool2D, args)) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -475,12 +345,10 @@ bool SpawnLinearNode(neurons::Network& network, bool& freeze_editor) {
 
     ImGui::SameLine();
     if (ImGui::Button("Add Node")) {
-      // Check that arguments are valid
-      bool args_valid = (n_args[0] > 0 && n_args[1] > 0);
-
-      if (args_valid) {
-        network.AddNode(Linear,std::make_unique<fl::Linear>(
-            fl::Linear(n_args[0], n_args[1], bias)));
+      // arguments valid if both sizes are positive
+      if (AddModuleNode(network, Linear,
+          {static_cast<double>(n_args[0]), static_cast<double>(n_args[1]),
+           bias ? 1.0 : 0.0})) {
         node_created = true;
         freeze_editor = false;
         ImGui::CloseCurrentPopup();
@@ -517,11 +385,11 @@ bool SpawnModuleNode(neurons::Network& network, neurons::NodeType type,
     case GatedLinearUnit:
     case LogSoftmax:
     case Log:
-      return SpawnActivationNode(network, type);
     case CategoricalCrossEntropy:
     case MeanAbsoluteError:
     case MeanSquaredError:
-      return SpawnLossNode(network, type);
+      // activation and loss nodes take no arguments
+      return AddModuleNode(network, type, {});
     case BatchNorm:
       return SpawnBatchNormNode(network, freeze_editor);
     case LayerNorm:
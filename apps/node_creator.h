@@ -7,12 +7,16 @@
 #include <imgui_adapter/node-adapter.h>
 #include <neurons/network.h>
 
+#include "mnist-utilities.h"
+
 namespace neurons::spawner {
 
-// Spawn an MNIST DataNode in the passed network with the
-// passed data directory and batch size. Returns true on success.
+// Spawn an MNIST DataNode in the passed network serving the passed splits
+// with the passed batch size, as mnist_utilities::add_data_node. Returns
+// true on success.
 bool SpawnMnistDataNode(neurons::Network& network,
-    const std::string& data_directory, dim_t batch_size);
+    const mnist_utilities::MnistSplits& splits, dim_t batch_size,
+    size_t prefetch_threads, size_t prefetch_depth);
 
 // Spawn a Node of the passed Node type. Returns true if successful. Freezes
 // editor when called, unfreezes editor once action is completed.
@@ -0,0 +1,234 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+// Times the graph algorithms of neurons on synthetic architectures of
+// 10^2 nodes up to a maximum size, printing one CSV row per operation.
+// Usage: graph-benchmark [max_nodes] [repetitions]
+//
+// best_ns_per_element is the fastest time divided by the number of nodes
+// and links, so it stays flat across sizes for linear-time operations and
+// grows with the size for quadratic ones.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <neurons/graph-snapshot.h>
+#include <neurons/network-container.h>
+#include <neurons/network.h>
+#include <neurons/utilities.h>
+
+#include "graph-generators.h"
+
+namespace neurons::benchmark {
+
+const size_t kMinNodes = 100;
+const size_t kDefaultMaxNodes = 1000000;
+const size_t kDefaultRepetitions = 3;
+
+// Accumulates results of timed calls so they are not optimized away.
+size_t sink = 0;
+
+// Returns the number of seconds taken to call function.
+template <typename Function>
+double Time(Function&& function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Timings of every operation on one GraphSpec, by operation name.
+// Operations are kept in the order they were first timed.
+class Timings {
+
+ public:
+
+  // Time function and record it under the operation name.
+  template <typename Function>
+  void Record(const std::string& operation, Function&& function) {
+    double seconds = Time(std::forward<Function>(function));
+    for (auto& timing : timings_) {
+      if (timing.first == operation) {
+        timing.second.push_back(seconds);
+        return;
+      }
+    }
+    timings_.push_back({operation, {seconds}});
+  }
+
+  // Print a CSV row for every operation with the fastest and mean time.
+  void Print(std::ostream& output, const GraphSpec& spec) const {
+    const size_t elements = spec.node_count_ + spec.links_.size();
+    for (const auto& timing : timings_) {
+      double best = timing.second.front();
+      double total = 0;
+      for (double seconds : timing.second) {
+        best = std::min(best, seconds);
+        total += seconds;
+      }
+      output << GraphShapeToString(spec.shape_) << ","
+             << spec.node_count_ << ","
+             << spec.links_.size() << ","
+             << timing.first << ","
+             << timing.second.size() << ","
+             << best << ","
+             << total / static_cast<double>(timing.second.size()) << ","
+             << best * 1e9 / static_cast<double>(elements) << std::endl;
+    }
+  }
+
+ private:
+
+  std::vector<std::pair<std::string, std::vector<double>>> timings_;
+
+};
+
+// Time building, querying and tearing down a Network of the GraphSpec.
+void TimeNetwork(const GraphSpec& spec, Timings& timings) {
+  Network network;
+  std::vector<std::shared_ptr<Node>> nodes;
+
+  timings.Record("Network::AddNode", [&] {
+    nodes = AddGraphNodes(network, spec);
+  });
+  timings.Record("Network::AddLink", [&] {
+    if (AddGraphLinks(network, spec, nodes) != 0) {
+      throw std::logic_error("Generated " + GraphShapeToString(spec.shape_) +
+          " graph has a rejected link.");
+    }
+  });
+
+  // views and snapshots are built on the first call after a modification
+  timings.Record("Network::GetNodes", [&] {
+    sink += network.GetNodes().size();
+  });
+  timings.Record("Network::GetLinks", [&] {
+    sink += network.GetLinks().size();
+  });
+  std::shared_ptr<const GraphSnapshot> snapshot;
+  timings.Record("Network::GetSnapshot", [&] {
+    snapshot = network.GetSnapshot();
+  });
+  timings.Record("Network::CountComponents", [&] {
+    sink += network.CountComponents();
+  });
+
+  const NodeDeque& node_deque = network.GetNodes();
+  const std::deque<Link>& link_deque = network.GetLinks();
+
+  timings.Record("GraphSnapshot", [&] {
+    sink += GraphSnapshot(node_deque, link_deque).GetTopologicalOrder().size();
+  });
+
+  std::vector<size_t> sources;
+  std::vector<size_t> targets;
+  for (size_t i = 0; i < link_deque.size(); ++i) {
+    sources.push_back(snapshot->GetLinkInput(i));
+    targets.push_back(snapshot->GetLinkOutput(i));
+  }
+  timings.Record("utilities::BuildAdjacencyList(indices)", [&] {
+    sink += utilities::BuildAdjacencyList(node_deque.size(), sources,
+        targets).NodeCount();
+  });
+  timings.Record("utilities::BuildAdjacencyList", [&] {
+    sink += utilities::BuildAdjacencyList(node_deque, link_deque).NodeCount();
+  });
+  timings.Record("utilities::TopologicalOrder", [&] {
+    sink += utilities::TopologicalOrder(snapshot->GetOutEdges()).size();
+  });
+  timings.Record("utilities::StrongComponents", [&] {
+    sink += utilities::StrongComponents(snapshot->GetOutEdges(),
+        snapshot->GetInEdges()).size();
+  });
+  timings.Record("utilities::NodesAndLinksConsistent", [&] {
+    sink += utilities::NodesAndLinksConsistent(node_deque, link_deque);
+  });
+  timings.Record("utilities::TopologicalSort", [&] {
+    sink += utilities::TopologicalSort(node_deque, link_deque).size();
+  });
+  timings.Record("utilities::TopologicalSort(snapshot)", [&] {
+    sink += utilities::TopologicalSort(*snapshot).size();
+  });
+  timings.Record("utilities::ContainsDirectedCycle", [&] {
+    sink += utilities::ContainsDirectedCycle(node_deque, link_deque);
+  });
+  timings.Record("utilities::CountConnectedComponents", [&] {
+    sink += utilities::CountConnectedComponents(node_deque, link_deque);
+  });
+  timings.Record("utilities::AreNodeInputsSatisfied", [&] {
+    sink += utilities::AreNodeInputsSatisfied(node_deque, link_deque);
+  });
+  timings.Record("utilities::AreNodeOutputsSatisfied", [&] {
+    sink += utilities::AreNodeOutputsSatisfied(node_deque, link_deque);
+  });
+  timings.Record("utilities::ValidateGraph", [&] {
+    sink += utilities::ValidateGraph(node_deque, link_deque).size();
+  });
+  timings.Record("utilities::ValidateGraph(snapshot)", [&] {
+    sink += utilities::ValidateGraph(*snapshot).size();
+  });
+
+  timings.Record("NetworkContainer", [&] {
+    sink += NetworkContainer(node_deque, link_deque).modules().size();
+  });
+  timings.Record("NetworkContainer(snapshot)", [&] {
+    sink += NetworkContainer(*snapshot).modules().size();
+  });
+
+  // release the snapshot first, so it is not destroyed while deleting nodes
+  snapshot.reset();
+  timings.Record("Network::DeleteNode", [&] {
+    for (const auto& node : nodes) {
+      network.DeleteNode(*node);
+    }
+  });
+}
+
+}  // namespace neurons::benchmark
+
+int main(int argc, char** argv) {
+  using namespace neurons::benchmark;
+
+  size_t max_nodes = kDefaultMaxNodes;
+  size_t repetitions = kDefaultRepetitions;
+  try {
+    if (argc > 1) {
+      max_nodes = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+      repetitions = std::stoul(argv[2]);
+    }
+  } catch (const std::exception&) {
+    std::cerr << "Usage: " << argv[0] << " [max_nodes] [repetitions]"
+              << std::endl;
+    return 1;
+  }
+  if (max_nodes < kMinNodes || repetitions == 0) {
+    std::cerr << "max_nodes must be at least " << kMinNodes
+              << " and repetitions must be positive." << std::endl;
+    return 1;
+  }
+
+  std::cout << "shape,nodes,links,operation,repetitions,best_seconds,"
+               "mean_seconds,best_ns_per_element" << std::endl;
+
+  for (size_t node_count = kMinNodes; node_count <= max_nodes;
+       node_count *= 10) {
+    for (GraphShape shape : kGraphShapes) {
+      GraphSpec spec = GenerateGraph(shape, node_count);
+      Timings timings;
+      for (size_t i = 0; i < repetitions; ++i) {
+        TimeNetwork(spec, timings);
+      }
+      timings.Print(std::cout, spec);
+    }
+  }
+
+  // print the sink so no timed call can be optimized away
+  std::cerr << "checksum: " << sink << std::endl;
+  return 0;
+}
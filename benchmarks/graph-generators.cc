@@ -0,0 +1,105 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include "graph-generators.h"
+
+#include <stdexcept>
+
+namespace neurons::benchmark {
+
+std::string GraphShapeToString(GraphShape shape) {
+  switch (shape) {
+    case Chain: return "chain";
+    case Fan: return "fan";
+    case Diamond: return "diamond";
+    case Ladder: return "ladder";
+    default: return "unknown";
+  }
+}
+
+GraphSpec GenerateGraph(GraphShape shape, size_t node_count) {
+  // every shape needs a data node, a loss node and a module between them
+  if (node_count < 3) {
+    throw std::invalid_argument("Generated graphs need at least 3 nodes.");
+  }
+
+  GraphSpec spec = {shape, node_count, {}};
+  auto& links = spec.links_;
+  const size_t loss = node_count - 1;
+
+  switch (shape) {
+    case Chain:
+      for (size_t i = 0; i < loss; ++i) {
+        links.emplace_back(i, i + 1);
+      }
+      break;
+
+    case Fan:
+      for (size_t i = 1; i < loss; ++i) {
+        links.emplace_back(0, i);
+      }
+      for (size_t i = 1; i < loss; ++i) {
+        links.emplace_back(i, loss);
+      }
+      break;
+
+    case Diamond: {
+      // each diamond uses three nodes: two branches and the node joining them
+      size_t current = 0;
+      size_t next = 1;
+      while (next + 3 <= loss) {
+        links.emplace_back(current, next);
+        links.emplace_back(current, next + 1);
+        links.emplace_back(next, next + 2);
+        links.emplace_back(next + 1, next + 2);
+        current = next + 2;
+        next += 3;
+      }
+      // chain the leftover nodes that do not fill a diamond
+      for (; next <= loss; ++next) {
+        links.emplace_back(current, next);
+        current = next;
+      }
+      break;
+    }
+
+    case Ladder:
+      for (size_t i = 0; i < loss; ++i) {
+        links.emplace_back(i, i + 1);
+        // residual link around the ReLU i, from the ReLU before it
+        if (i >= 2 && i % 2 == 0) {
+          links.emplace_back(i - 1, i + 1);
+        }
+      }
+      break;
+  }
+
+  return spec;
+}
+
+std::vector<std::shared_ptr<Node>> AddGraphNodes(Network& network,
+    const GraphSpec& spec) {
+  std::vector<std::shared_ptr<Node>> nodes;
+  nodes.reserve(spec.node_count_);
+  nodes.push_back(network.AddNode(nullptr, nullptr, nullptr));
+  for (size_t i = 1; i + 1 < spec.node_count_; ++i) {
+    nodes.push_back(network.AddNode(NodeType::ReLU,
+        std::make_unique<fl::ReLU>()));
+  }
+  nodes.push_back(network.AddNode(NodeType::MeanSquaredError,
+      std::make_unique<fl::MeanSquaredError>()));
+  return nodes;
+}
+
+size_t AddGraphLinks(Network& network, const GraphSpec& spec,
+    const std::vector<std::shared_ptr<Node>>& nodes) {
+  size_t rejected = 0;
+  for (const auto& link : spec.links_) {
+    if (network.AddLink(nodes.at(link.first), nodes.at(link.second))
+        == nullptr) {
+      ++rejected;
+    }
+  }
+  return rejected;
+}
+
+}  // namespace neurons::benchmark
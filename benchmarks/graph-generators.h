@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#ifndef FINALPROJECT_BENCHMARKS_GRAPH_GENERATORS_H_
+#define FINALPROJECT_BENCHMARKS_GRAPH_GENERATORS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <neurons/network.h>
+
+namespace neurons::benchmark {
+
+// Shapes of the synthetic architectures.
+// Chain: data -> ReLU -> ... -> ReLU -> loss
+// Fan: data -> every ReLU -> loss, i.e. one layer as wide as the graph
+// Diamond: a chain of diamonds, each splitting into two ReLUs and joining
+// Ladder: a chain with a residual link skipping over every second ReLU
+enum GraphShape { Chain, Fan, Diamond, Ladder };
+
+// Get the GraphShape as an std::string
+std::string GraphShapeToString(GraphShape shape);
+
+// Every GraphShape, in declaration order.
+const std::vector<GraphShape> kGraphShapes = {Chain, Fan, Diamond, Ladder};
+
+// A synthetic architecture described by node indices.
+// Index 0 is the data node, index node_count_ - 1 is the loss node and every
+// other index is a ReLU node. Links are ordered so that no link is added
+// before the links to its input.
+struct GraphSpec {
+  GraphShape shape_;
+  size_t node_count_;
+  std::vector<std::pair<size_t, size_t>> links_;
+};
+
+// Generates a valid GraphSpec of the shape with node_count nodes.
+// Throws std::invalid_argument if node_count is too small for the shape
+// to have both a data node and a loss node.
+GraphSpec GenerateGraph(GraphShape shape, size_t node_count);
+
+// Add the nodes of the GraphSpec to the network, returning them by index.
+// The data node has no datasets, so the network can only be validated and
+// built into a NetworkContainer, not trained.
+std::vector<std::shared_ptr<Node>> AddGraphNodes(Network& network,
+    const GraphSpec& spec);
+
+// Add the links of the GraphSpec between the passed nodes to the network.
+// Returns the number of links that were rejected.
+size_t AddGraphLinks(Network& network, const GraphSpec& spec,
+    const std::vector<std::shared_ptr<Node>>& nodes);
+
+}  // namespace neurons::benchmark
+
+#endif  // FINALPROJECT_BENCHMARKS_GRAPH_GENERATORS_H_
@@ -0,0 +1,71 @@
+# Build configurations for measuring and shipping optimized builds.
+#
+# NEURONS_COVERAGE  Instrument for code coverage (off by default, since
+#                   instrumented timings are meaningless).
+# NEURONS_LTO       Enable link-time optimization where supported.
+# NEURONS_PGO       Profile-guided optimization: GENERATE builds
+#                   instrumented binaries that write profiles to
+#                   NEURONS_PGO_DIR when run, USE rebuilds with them.
+#                   Clang profiles must first be merged into
+#                   ${NEURONS_PGO_DIR}/default.profdata with llvm-profdata.
+#
+# A typical PGO build trains on a representative workload, e.g.
+#   cmake -DCMAKE_BUILD_TYPE=Release -DNEURONS_PGO=GENERATE ..
+#   run neurons-trainer or graph-benchmark
+#   cmake -DNEURONS_PGO=USE .. and rebuild
+
+option(NEURONS_COVERAGE "Instrument for code coverage" OFF)
+option(NEURONS_LTO "Enable link-time optimization" OFF)
+set(NEURONS_PGO "" CACHE STRING
+    "Profile-guided optimization stage: empty, GENERATE or USE")
+set_property(CACHE NEURONS_PGO PROPERTY STRINGS "" GENERATE USE)
+set(NEURONS_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH
+    "Directory of the profile-guided optimization profiles")
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "(Apple)?[Cc]lang")
+    set(NEURONS_CLANG ON)
+endif()
+
+if(NEURONS_COVERAGE)
+    if(NEURONS_PGO)
+        message(FATAL_ERROR "NEURONS_COVERAGE and NEURONS_PGO both "
+                "instrument the build, enable only one.")
+    endif()
+    if(NEURONS_CLANG)
+        message("Building with llvm Code Coverage Tools")
+        string(APPEND CMAKE_CXX_FLAGS
+               " -fprofile-instr-generate -fcoverage-mapping")
+    elseif(CMAKE_COMPILER_IS_GNUCXX)
+        message("Building with lcov Code Coverage Tools")
+        string(APPEND CMAKE_CXX_FLAGS " --coverage")
+    endif()
+endif()
+
+if(NEURONS_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT NEURONS_LTO_SUPPORTED OUTPUT NEURONS_LTO_ERROR)
+    if(NEURONS_LTO_SUPPORTED)
+        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+    else()
+        message(WARNING "LTO is not supported: ${NEURONS_LTO_ERROR}")
+    endif()
+endif()
+
+if(NEURONS_PGO AND MSVC)
+    message(FATAL_ERROR "NEURONS_PGO is only supported with GCC and Clang.")
+elseif(NEURONS_PGO STREQUAL "GENERATE")
+    string(APPEND CMAKE_CXX_FLAGS " -fprofile-generate=${NEURONS_PGO_DIR}")
+elseif(NEURONS_PGO STREQUAL "USE")
+    if(NEURONS_CLANG)
+        string(APPEND CMAKE_CXX_FLAGS
+               " -fprofile-use=${NEURONS_PGO_DIR}/default.profdata")
+    else()
+        # profiles of code that changed since they were written are
+        # dropped rather than failing the build
+        string(APPEND CMAKE_CXX_FLAGS
+               " -fprofile-use=${NEURONS_PGO_DIR} -fprofile-correction"
+               " -Wno-missing-profile")
+    endif()
+elseif(NEURONS_PGO)
+    message(FATAL_ERROR "NEURONS_PGO must be empty, GENERATE or USE.")
+endif()
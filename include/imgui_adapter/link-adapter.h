@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "neurons/link.h"
+#include "neurons/network.h"
 
 namespace neurons::adapter {
 
@@ -17,14 +18,16 @@ struct LinkAdapter {
   size_t start_id_;
   size_t end_id_;
 
-  Link* link_;
+  // Handle of the Link in its Network. Unlike a pointer, the Handle stays
+  // safe to resolve with Network::GetLink after the Network is modified.
+  Handle handle_;
 
-  // Constructor from Link
-  explicit LinkAdapter(Link& link);
+  // Constructor from Link and its Handle
+  LinkAdapter(const Link& link, const Handle& handle);
 };
 
-// Return a vector of LinkAdapters wrapped around the passed links
-std::vector<LinkAdapter> BuildLinkAdapters(std::deque<Link>& links);
+// Return a vector of LinkAdapters wrapped around the links of the network
+std::vector<LinkAdapter> BuildLinkAdapters(const Network& network);
 
 // Returns a pointer to the Link in the passed vector with the passed link ID.
 // If multiple Links have the same link ID, will return the first one.
@@ -30,7 +30,7 @@ struct NodeAdapter {
 
 
 // Return a vector of NodeAdapters wrapped around the passed nodes
-std::vector<NodeAdapter> BuildNodeAdapters(NodeDeque& nodes);
+std::vector<NodeAdapter> BuildNodeAdapters(const NodeDeque& nodes);
 
 // Returns a pointer to a Node in the passed vector that owns the node ID.
 // If multiple nodes have the node ID, will return the first one.
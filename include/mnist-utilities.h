@@ -2,8 +2,13 @@
 #define FINALPROJECT_MNIST_UTILITIES_H_
 
 #include <flashlight/flashlight.h>
+#include <neurons/classification-metrics.h>
 #include <neurons/data-node.h>
+#include <neurons/record-source.h>
 
+#include <functional>
+
+#include "neurons/network.h"
 #include "neurons/network-container.h"
 
 namespace neurons::mnist_utilities {
@@ -14,31 +19,124 @@ namespace neurons::mnist_utilities {
 // using the byte-form MNIST datasets: http://yann.lecun.com/exdb/mnist/
 
 const int kTrainSize = 60000;
-const int kValSize = 5000; /* Held-out from train. */
+const int kValSize = 5000; /* Default held-out from train. */
 const int kTestSize = 10000;
 const int kImDim = 28;
 const int kPixelMax = 255;
 const int kInputIdx = 0;
 const int kTargetIdx = 1;
+// Pixels are rescaled to [-0.5, 0.5] as (pixel + offset) * scale
+const float kPixelOffset = -static_cast<float>(kPixelMax / 2);
+const float kPixelScale = 1.0f / kPixelMax;
+
+// Default number of train batches between reads of the running train loss
+// from the device.
+const int kLossReadbackInterval = 200;
+
+// MNIST inputs as u8 pixels and targets as s32 labels, split into train
+// and test sets. The validation set is held out from the train set by the
+// datasets that serve it, which also normalize inputs per batch with
+// kPixelOffset and kPixelScale.
+struct MnistSplits {
+  af::array train_x_;
+  af::array train_y_;
+  af::array test_x_;
+  af::array test_y_;
+};
+
+// Load the MNIST splits from the IDX files in data_dir. The files are
+// memory-mapped, so the pixels are copied to the arrays without being read
+// into an intermediate buffer.
+MnistSplits load_splits(const std::string& data_dir);
+
+// Add a DataNode to network serving the passed splits with the passed batch
+// size. The validation set is held out from the train set, which is
+// shuffled every epoch, and also augmented if augment is set. Augmentation
+// can be toggled later through DataNode::SetAugmentation. Each dataset
+// prefetches up to prefetch_depth batches ahead on prefetch_threads worker
+// threads.
+void add_data_node(neurons::Network& network, const MnistSplits& splits,
+    dim_t batch_size, size_t prefetch_threads, size_t prefetch_depth,
+    bool augment = false);
+
+// Paths of the inputs and targets record files of a dataset split, in any
+// format read by neurons::OpenRecordFile.
+struct RecordFiles {
+  std::string inputs_;
+  std::string targets_;
+};
+
+// Add a DataNode to network streaming its splits from the passed record
+// files, whose shapes are read from their headers, so the splits need not
+// fit in memory. Inputs are normalized to (element + offset) * scale. Each
+// dataset prefetches up to prefetch_depth batches ahead on
+// prefetch_threads worker threads. Throws std::runtime_error if a file
+// cannot be opened, or std::invalid_argument if the inputs and targets of
+// a split do not match.
+void add_record_data_node(neurons::Network& network,
+    const RecordFiles& train, const RecordFiles& valid,
+    const RecordFiles& test, dim_t batch_size, float offset, float scale,
+    size_t prefetch_threads, size_t prefetch_depth);
+
+// Element types and record shapes of headerless input and target files,
+// which have no header to read them from.
+struct RawRecordLayout {
+  ElementType input_type_;
+  std::vector<size_t> input_shape_;
+  ElementType target_type_;
+  std::vector<size_t> target_shape_;
+};
+
+// Same as add_record_data_node, for headerless files of native byte order
+// records laid out as layout describes, as read by RecordFile::OpenRaw.
+// Throws std::runtime_error if a file cannot be opened or does not hold a
+// whole number of records.
+void add_raw_record_data_node(neurons::Network& network,
+    const RecordFiles& train, const RecordFiles& valid,
+    const RecordFiles& test, const RawRecordLayout& layout,
+    dim_t batch_size, float offset, float scale, size_t prefetch_threads,
+    size_t prefetch_depth);
+
+// Add a DataNode to network serving generated examples of the passed dims
+// and class count, so networks can be trained and timed without data
+// files or disk I/O. The splits share the classes and hold the passed
+// numbers of examples, and are the same for every run with the same seed.
+// Throws std::invalid_argument if a count or size is not positive.
+void add_synthetic_data_node(neurons::Network& network,
+    const af::dim4& example_dims, int class_count, dim_t train_size,
+    dim_t eval_size, dim_t batch_size, uint64_t seed);
 
-// Load data from MNIST files from data_dir.
-std::pair<af::array, af::array> load_dataset(const std::string& data_dir,
-    bool test = false);
+// Called by train_model as training progresses, for callers that record
+// more than the log. Empty functions are not called.
+struct TrainCallbacks {
+  // Called after each epoch with the epoch, average train loss and
+  // validation metrics.
+  std::function<void(int, double, const ClassificationMetrics::Results&)>
+      on_epoch_;
+  // Called once after training with the test metrics.
+  std::function<void(const ClassificationMetrics::Results&)> on_test_;
+};
 
-// Return a pair of categorical cross entropy loss and
-// error for the model evaluated on the passed dataset.
-std::pair<double, double> eval_loop(neurons::NetworkContainer& model,
+// Return the categorical cross entropy loss, error and per-class metrics of
+// the model evaluated on the passed dataset. The metrics are accumulated on
+// the device and read back once, after the last batch.
+ClassificationMetrics::Results eval_loop(neurons::NetworkContainer& model,
     fl::Dataset& dataset);
 
 // Train the passed model with the passed data node with the optimizer
 // for the passed number of epochs. Uses categorical cross entropy loss and
-// writes model training log to output. Sets training to whether training
-// is still in progress (allows for checking in multi-threaded programs).
+// writes model training log to output. The running train loss is read
+// from the device, and logged, every readback_interval batches, or only at
+// the end of each epoch if readback_interval is 0. Sets training to whether
+// training is still in progress (allows for checking in multi-threaded
+// programs).
 // If training becomes false during run, it will stop the process.
-// Writes any exceptions that happens to exception_ptr.
+// Writes any exceptions that happens to exception_ptr. Calls callbacks
+// after every epoch and after testing.
 void train_model(neurons::NetworkContainer& model, neurons::DataNode& data,
-    fl::FirstOrderOptimizer& optimizer, int epochs, std::ostream& output,
-    bool& training, std::exception_ptr& exception_ptr);
+    fl::FirstOrderOptimizer& optimizer, int epochs, int readback_interval,
+    std::ostream& output, bool& training, std::exception_ptr& exception_ptr,
+    const TrainCallbacks& callbacks);
 
 }  // namespace neurons::mnist_utilities
 
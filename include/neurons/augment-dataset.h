@@ -0,0 +1,76 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_AUGMENT_DATASET_H_
+#define FINALPROJECT_NEURONS_AUGMENT_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+#include "epoch-dataset.h"
+
+namespace neurons {
+
+// Amounts of the random distortions applied to every input image. An
+// amount of 0 disables the distortion.
+struct Augmentation {
+  // Largest shift along each axis, in pixels
+  float max_shift_;
+  // Largest rotation about the image center, in radians
+  float max_rotation_;
+  // Scale of the elastic displacement field, in pixels before smoothing
+  float elastic_alpha_;
+  // Standard deviation of the Gaussian smoothing the displacement field,
+  // in pixels. Larger values give smoother distortions.
+  float elastic_sigma_;
+  // Standard deviation of the Gaussian noise added to every element
+  float noise_;
+};
+
+// Dataset serving the samples of another dataset with their inputs randomly
+// shifted, rotated, elastically distorted and noised. The inputs are the
+// first array of a sample, with images along dims 0 and 1 and examples
+// along dim 3; the other arrays pass through unchanged.
+// Whole batches are distorted at once by sampling every image at displaced
+// coordinates, so wrap this in a PrefetchDataset to augment on its worker
+// threads. Samples outside the image repeat its edge.
+// The distortions depend only on the seed, the epoch and the sample index.
+class AugmentDataset : public WrapperDataset {
+
+ public:
+
+  // Public constructor. Throws std::invalid_argument if dataset is null or
+  // an amount of augmentation is negative.
+  AugmentDataset(std::shared_ptr<fl::Dataset> dataset,
+                 const Augmentation& augmentation, uint64_t seed);
+
+  // Get the sample at idx of the wrapped dataset, augmented if enabled.
+  [[nodiscard]] std::vector<af::array> get(int64_t idx) const override;
+
+  // Begin the epoch here and on the wrapped dataset.
+  void BeginEpoch(size_t epoch) override;
+
+  // Set whether samples are augmented. Enabled on construction.
+  void SetEnabled(bool enabled);
+
+  // Returns whether samples are augmented.
+  [[nodiscard]] bool IsEnabled() const;
+
+  // Get the amounts of augmentation.
+  [[nodiscard]] const Augmentation& GetAugmentation() const;
+
+ private:
+
+  Augmentation augmentation_;
+  uint64_t seed_;
+  size_t epoch_;
+  bool enabled_;
+
+};
+
+// Returns the passed batch of images distorted by the passed augmentation,
+// drawing the distortions from engine. Images are along dims 0 and 1 and
+// examples along dim 3. Single row or column inputs are only noised.
+af::array Augment(const af::array& images, const Augmentation& augmentation,
+                  af::randomEngine& engine);
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_AUGMENT_DATASET_H_
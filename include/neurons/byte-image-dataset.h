@@ -0,0 +1,105 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_BYTE_IMAGE_DATASET_H_
+#define FINALPROJECT_NEURONS_BYTE_IMAGE_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+#include "epoch-dataset.h"
+
+namespace neurons {
+
+// Batched dataset of unsigned byte images and integer labels. Images stay
+// bytes in memory, a quarter of the size of float pixels, and each batch is
+// converted to (pixel + offset) * scale only when it is retrieved.
+// A dataset is a view of a range of examples in storage shared with the
+// datasets it was made from, so splits of one set of examples can be made
+// and resized without copying them.
+// Examples are served in storage order unless shuffling is enabled, in
+// which case every epoch gathers its batches through a new permutation of
+// the example indices; the examples themselves are never reordered.
+class ByteImageDataset : public EpochDataset {
+
+ public:
+
+  // Public constructor for a view of all the passed examples. images must
+  // be u8 with one example per index of its last dimension (dim 3), and
+  // labels must have one label per example along dim 0. The last batch
+  // holds the remaining examples, and may be smaller than batch_size.
+  // Throws std::invalid_argument if the types or example counts do not
+  // match, or batch_size is not positive.
+  ByteImageDataset(af::array images, af::array labels, dim_t batch_size,
+                   float offset, float scale);
+
+  // Public constructor for a view of examples [begin, end) of the storage of
+  // other, with the same batch size and normalization and no shuffling.
+  // Throws std::invalid_argument if the range is out of bounds.
+  ByteImageDataset(const ByteImageDataset& other, dim_t begin, dim_t end);
+
+  // Get the number of batches.
+  [[nodiscard]] int64_t size() const override;
+
+  // Get the normalized inputs and the labels of the batch at idx.
+  // Throws std::out_of_range if idx is not a batch index.
+  [[nodiscard]] std::vector<af::array> get(int64_t idx) const override;
+
+  // View examples [begin, end) of the storage instead.
+  // Throws std::invalid_argument if the range is out of bounds.
+  void SetRange(dim_t begin, dim_t end);
+
+  // Batch the examples by batch_size instead. Nothing is copied.
+  // Throws std::invalid_argument if batch_size is not positive.
+  void SetBatchSize(dim_t batch_size);
+
+  // Shuffle the examples every epoch. The epoch 0 permutation is used until
+  // the next BeginEpoch(). The permutation of an epoch depends only on seed,
+  // the epoch number and the range, so runs with the same seed see the same
+  // batches.
+  void EnableShuffle(uint64_t seed);
+
+  // Serve the examples in storage order again.
+  void DisableShuffle();
+
+  // Permute the examples for the passed epoch, if shuffling is enabled.
+  void BeginEpoch(size_t epoch) override;
+
+  // Returns whether both datasets view the same storage.
+  [[nodiscard]] bool SharesStorage(const ByteImageDataset& other) const;
+
+  // Get the number of examples in the storage.
+  [[nodiscard]] dim_t GetStorageSize() const;
+
+  // Get the storage index of the first example in the view.
+  [[nodiscard]] dim_t GetRangeBegin() const;
+
+  // Get the number of examples in the view.
+  [[nodiscard]] dim_t GetExampleCount() const;
+
+  // Get the number of examples per batch.
+  [[nodiscard]] dim_t GetBatchSize() const;
+
+ private:
+
+  struct Storage {
+    af::array images_;
+    af::array labels_;
+  };
+
+  std::shared_ptr<const Storage> storage_;
+  // Storage indices of the examples in the view are [begin_, end_)
+  dim_t begin_;
+  dim_t end_;
+  dim_t batch_size_;
+  float offset_;
+  float scale_;
+
+  bool shuffle_;
+  uint64_t seed_;
+  size_t epoch_;
+  // Storage index of the example at each position, or empty for range order
+  af::array order_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_BYTE_IMAGE_DATASET_H_
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_CLASSIFICATION_METRICS_H_
+#define FINALPROJECT_NEURONS_CLASSIFICATION_METRICS_H_
+
+#include <flashlight/flashlight.h>
+
+#include <vector>
+
+namespace neurons {
+
+// Loss, error and confusion matrix of a classifier over a whole dataset.
+// The totals are accumulated on the device batch by batch and read back
+// only by Read(). Add() reads back only whether its targets are in range.
+class ClassificationMetrics {
+
+ public:
+
+  // Totals read back from the device.
+  struct Results {
+    // Number of examples added
+    size_t example_count_;
+    // Mean loss per example
+    double loss_;
+    // Percentage of examples predicted wrong
+    double error_;
+    // Examples by target class and predicted class, row-major:
+    // confusion_[target * class count + prediction]
+    std::vector<size_t> confusion_;
+    // Fraction of the predictions of each class that were right, or 0 if
+    // the class was never predicted
+    std::vector<double> precision_;
+    // Fraction of the examples of each class that were predicted right, or
+    // 0 if the class has no examples
+    std::vector<double> recall_;
+  };
+
+  // Public constructor for class_count classes.
+  // Throws std::invalid_argument if class_count is not positive.
+  explicit ClassificationMetrics(int class_count);
+
+  // Add a batch. outputs holds the class scores of each example along
+  // dim 0, and examples along dim 1. targets holds the s32 class of each
+  // example. loss is the mean loss of the batch. Only whether every target
+  // is a class is read back. Throws std::invalid_argument if the dims do
+  // not match the class count or each other, or if a target is not in
+  // [0, class count).
+  void Add(const af::array& outputs, const af::array& targets,
+           const af::array& loss);
+
+  // Read the totals of the batches added since construction or the last
+  // Reset() back from the device.
+  [[nodiscard]] Results Read() const;
+
+  // Clear the totals.
+  void Reset();
+
+  // Get the number of classes.
+  [[nodiscard]] int GetClassCount() const;
+
+ private:
+
+  int class_count_;
+  // Confusion matrix counts, flattened as in Results::confusion_
+  af::array confusion_;
+  // Sum of the losses of every example
+  af::array loss_sum_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_CLASSIFICATION_METRICS_H_
@@ -19,6 +19,32 @@ class DataNode : public Node {
   // Pretty string
   [[nodiscard]] std::string prettyString() const override;
 
+  // Prepare the datasets for the passed training epoch, e.g. reshuffle the
+  // train set. Must not be called while the datasets are being iterated.
+  void BeginEpoch(size_t epoch);
+
+  // Split the examples shared by the validation and train sets so that the
+  // passed fraction of them, from the front, is used for validation and the
+  // rest for training. The sets stay views of the same examples, so none
+  // are copied. Returns false, changing nothing, if the sets are not
+  // ByteImageDatasets of the same storage, e.g. the separate files of a
+  // RecordDataset, or fraction is not in [0, 1).
+  // Must not be called while the datasets are being iterated.
+  bool SetValidationSplit(double fraction);
+
+  // Batch the train set by train_batch_size, and the validation and test
+  // sets by eval_batch_size, which can be larger as evaluation keeps no
+  // activations for backpropagation. The examples are not copied.
+  // Returns false, changing nothing, if any set is not a ByteImageDataset,
+  // RecordDataset or SyntheticDataset, or either size is not positive.
+  // Must not be called while the datasets are being iterated.
+  bool SetBatchSizes(dim_t train_batch_size, dim_t eval_batch_size);
+
+  // Set whether the train set is augmented. Returns false, changing
+  // nothing, if the train set has no AugmentDataset.
+  // Must not be called while the datasets are being iterated.
+  bool SetAugmentation(bool enabled);
+
   // datasets are public members as various functions such as DatasetIterator
   // need a non-const reference to it
   std::unique_ptr<fl::Dataset> train_dataset_;
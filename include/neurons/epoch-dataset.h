@@ -0,0 +1,65 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_EPOCH_DATASET_H_
+#define FINALPROJECT_NEURONS_EPOCH_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+namespace neurons {
+
+// Dataset that can change between training epochs, e.g. reorder its
+// samples. Plain fl::Datasets are the same every epoch.
+class EpochDataset : public fl::Dataset {
+
+ public:
+
+  // Prepare the dataset for iteration in the passed epoch. Must not be
+  // called while another thread retrieves samples.
+  virtual void BeginEpoch(size_t epoch) = 0;
+
+};
+
+// EpochDataset serving the samples of another dataset, e.g. prepared
+// ahead of time or transformed. Epochs are begun on the wrapped dataset
+// too.
+class WrapperDataset : public EpochDataset {
+
+ public:
+
+  // Public constructor. Throws std::invalid_argument if dataset is null.
+  explicit WrapperDataset(std::shared_ptr<fl::Dataset> dataset);
+
+  // Get the number of samples of the wrapped dataset.
+  [[nodiscard]] int64_t size() const override;
+
+  // Begin the epoch on the wrapped dataset.
+  void BeginEpoch(size_t epoch) override;
+
+  // Get the wrapped dataset.
+  [[nodiscard]] const std::shared_ptr<fl::Dataset>& GetDataset() const;
+
+ protected:
+
+  std::shared_ptr<fl::Dataset> dataset_;
+
+};
+
+// Calls BeginEpoch on the dataset if it is an EpochDataset.
+void BeginEpoch(fl::Dataset& dataset, size_t epoch);
+
+// Returns the dataset of type T that is dataset or is wrapped by it through
+// WrapperDatasets, or nullptr if there is none. Drain any PrefetchDatasets
+// in between before modifying the returned dataset.
+template <typename T>
+T* FindDataset(fl::Dataset& dataset) {
+  if (auto* found = dynamic_cast<T*>(&dataset)) {
+    return found;
+  }
+  if (auto* wrapper = dynamic_cast<WrapperDataset*>(&dataset)) {
+    return FindDataset<T>(*wrapper->GetDataset());
+  }
+  return nullptr;
+}
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_EPOCH_DATASET_H_
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_GRAPH_SNAPSHOT_H_
+#define FINALPROJECT_NEURONS_GRAPH_SNAPSHOT_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "link.h"
+#include "node.h"
+#include "utilities.h"
+
+namespace neurons {
+
+// Immutable index-based view of a graph of Nodes and Links.
+// Nodes are identified by their dense index in the passed NodeDeque, and
+// edges are stored in compressed sparse row form in both directions, so
+// graph queries do not need to scan links or compare shared_ptrs.
+class GraphSnapshot {
+
+ public:
+
+  // Public constructor. Links with a node that is not in nodes are kept,
+  // but do not form an edge.
+  GraphSnapshot(const NodeDeque& nodes, const std::deque<Link>& links);
+
+  // Constructor for graphs already known to have no directed cycle, such as
+  // those maintained by Network. order must contain every node index,
+  // sorted topologically, and is used instead of sorting the graph again.
+  GraphSnapshot(const NodeDeque& nodes, const std::deque<Link>& links,
+                std::vector<size_t> order);
+
+  // Get the Nodes, in index order.
+  [[nodiscard]] const NodeDeque& GetNodes() const;
+
+  // Get the Links, in index order.
+  [[nodiscard]] const std::deque<Link>& GetLinks() const;
+
+  // Returns the index of the first node with the passed ID.
+  // Returns the number of nodes if no node has the ID.
+  [[nodiscard]] size_t GetNodeIndex(size_t node_id) const;
+
+  // Returns the node index of the input of the link at the passed index.
+  // Returns the number of nodes if the input is not in the snapshot.
+  [[nodiscard]] size_t GetLinkInput(size_t link) const;
+
+  // Returns the node index of the output of the link at the passed index.
+  // Returns the number of nodes if the output is not in the snapshot.
+  [[nodiscard]] size_t GetLinkOutput(size_t link) const;
+
+  // Get edges from every node to the nodes it serves as input for.
+  [[nodiscard]] const utilities::AdjacencyList& GetOutEdges() const;
+
+  // Get edges from every node to the nodes that serve as its input.
+  [[nodiscard]] const utilities::AdjacencyList& GetInEdges() const;
+
+  // Get the node indices sorted topologically, in the same order as
+  // utilities::TopologicalOrder unless an order was passed on construction.
+  [[nodiscard]] const std::vector<size_t>& GetTopologicalOrder() const;
+
+  // Returns whether the graph is known to have no directed cycle without
+  // checking, i.e. the snapshot was constructed with a topological order.
+  [[nodiscard]] bool IsKnownAcyclic() const;
+
+ private:
+
+  NodeDeque nodes_;
+  std::deque<Link> links_;
+
+  // Maps node IDs to node indices
+  std::unordered_map<size_t, size_t> node_indices_;
+
+  // Node indices of the input and output of every link
+  std::vector<size_t> link_inputs_;
+  std::vector<size_t> link_outputs_;
+
+  utilities::AdjacencyList out_edges_;
+  utilities::AdjacencyList in_edges_;
+
+  std::vector<size_t> order_;
+  bool known_acyclic_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_GRAPH_SNAPSHOT_H_
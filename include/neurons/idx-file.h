@@ -0,0 +1,49 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_IDX_FILE_H_
+#define FINALPROJECT_NEURONS_IDX_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mapped-file.h"
+
+namespace neurons {
+
+// Read-only memory mapping of an IDX file of unsigned bytes
+// (http://yann.lecun.com/exdb/mnist/). The header is validated on
+// construction, and the element bytes are read straight from the mapping,
+// so no copy of the file is made.
+class IdxFile {
+
+ public:
+
+  // Maps the file at path. Throws std::runtime_error if the file cannot be
+  // opened or mapped, is not an unsigned byte IDX file, or is shorter than
+  // its header claims.
+  explicit IdxFile(const std::string& path);
+
+  // Get the dimensions from the header, outermost first.
+  [[nodiscard]] const std::vector<size_t>& GetDims() const;
+
+  // Get the number of elements, i.e. the product of the dimensions.
+  [[nodiscard]] size_t GetElementCount() const;
+
+  // Get the first element. Elements are stored in row-major order.
+  [[nodiscard]] const unsigned char* GetData() const;
+
+  // Get the whole mapped file, header included.
+  [[nodiscard]] const MappedFile& GetFile() const;
+
+ private:
+
+  MappedFile file_;
+
+  std::vector<size_t> dims_;
+  size_t element_count_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_IDX_FILE_H_
@@ -0,0 +1,74 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_MAPPED_FILE_H_
+#define FINALPROJECT_NEURONS_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace neurons {
+
+// Read-only memory mapping of a file, or of a region of it. The mapping is
+// released when the MappedFile is destroyed. Mapping regions lets files
+// larger than memory, or address space, be read one chunk at a time.
+class MappedFile {
+
+ public:
+
+  // How the mapped bytes will be read, passed on to the OS where it takes
+  // advice. Sequential reads ahead aggressively and drops pages behind the
+  // reader, so only use it when the bytes are read in order.
+  enum class Access {
+    Normal, Sequential, Random
+  };
+
+  // Maps the file at path. Throws std::runtime_error if the file cannot be
+  // opened or mapped.
+  explicit MappedFile(const std::string& path, Access access = Access::Normal);
+
+  // Maps length bytes of the file at path starting at offset, or fewer if
+  // the file ends first. Throws std::runtime_error if the file cannot be
+  // opened or mapped, or is shorter than offset.
+  MappedFile(const std::string& path, size_t offset, size_t length,
+             Access access = Access::Normal);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // Get the first mapped byte. nullptr if nothing is mapped.
+  [[nodiscard]] const unsigned char* GetData() const;
+
+  // Get the number of mapped bytes.
+  [[nodiscard]] size_t GetSize() const;
+
+  // Get the size of the whole file in bytes.
+  [[nodiscard]] size_t GetFileSize() const;
+
+ private:
+
+  // Maps the region, clipped to the file.
+  void Map(const std::string& path, size_t offset, size_t length,
+           Access access);
+
+  // Unmaps the file, if mapped.
+  void Close();
+
+  const unsigned char* data_;
+  size_t size_;
+  size_t file_size_;
+  // Start and size of the mapping, which begins at a page boundary at or
+  // before data_
+  void* mapping_;
+  size_t mapping_size_;
+  // Platform handle of the mapping, where the platform needs one
+  void* handle_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_MAPPED_FILE_H_
@@ -3,6 +3,9 @@
 #define FINALPROJECT_NEURONS_NETWORK_CONTAINER_H_
 
 #include <flashlight/flashlight.h>
+#include <vector>
+
+#include "neurons/graph-snapshot.h"
 #include "neurons/link.h"
 #include "neurons/node.h"
 
@@ -30,8 +33,14 @@ class NetworkContainer : private fl::Container {
   // Public constructor.
   // Checks if passed nodes and links constitute a valid model.
   // Graphs must have no directed cycles, only consist of one component,
-  // and have node inputs and node outputs satisfied.
-  NetworkContainer(NodeDeque& nodes, const std::deque<Link>& links);
+  // and have node inputs and node outputs satisfied. The loss node must not
+  // be linked from the DataNode.
+  // Throws std::invalid_argument describing every violated requirement.
+  NetworkContainer(const NodeDeque& nodes, const std::deque<Link>& links);
+
+  // Same as above, reusing the adjacency of an existing GraphSnapshot
+  // (e.g. the one cached by Network::GetSnapshot).
+  explicit NetworkContainer(const GraphSnapshot& graph);
 
   std::vector<fl::Variable> forward(
       const std::vector<fl::Variable>& input) override;
@@ -40,6 +49,13 @@ class NetworkContainer : private fl::Container {
 
   fl::Variable operator()(const fl::Variable& input);
 
+  // Returns the peak number of bytes held in execution plan slots (module
+  // outputs and the container input) during the most recent forward pass.
+  // Only counts what the plan holds: while gradients are recorded, the
+  // autograd graph keeps every intermediate output until backward, so this
+  // matches real memory use only for eval/no-grad forward passes.
+  [[nodiscard]] size_t GetPeakSlotBytes() const;
+
   // Generates a stringified representation of the `NetworkContainer` by
   // concatenating string representations for each contained `Module`
   std::string prettyString() const override;
@@ -54,6 +70,27 @@ class NetworkContainer : private fl::Container {
   // Links connecting the modules
   const std::deque<Link> links_;
 
+  // Execution plan slot holding the container input (the data node output).
+  // Slot i + 1 holds the output of modules_.at(i).
+  static const size_t kDataSlot = 0;
+
+  // For each module in modules_, the slots whose outputs are summed to form
+  // the module input. Resolved from links_ once at construction.
+  std::vector<std::vector<size_t>> input_slots_;
+
+  // Slots whose outputs are summed to form the container output
+  // (i.e. the slots linked to the loss node).
+  std::vector<size_t> output_slots_;
+
+  // For each module in modules_, the slots that no later module reads.
+  // Their outputs are released as soon as the module has run. This frees
+  // memory in eval/no-grad forward passes; in training the autograd graph
+  // still references them until backward.
+  std::vector<std::vector<size_t>> release_slots_;
+
+  // Peak bytes held in slots during the most recent forward pass
+  size_t peak_slot_bytes_;
+
 };
 
 }  // namespace neurons
@@ -0,0 +1,77 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_NETWORK_SPEC_H_
+#define FINALPROJECT_NEURONS_NETWORK_SPEC_H_
+
+#include <flashlight/flashlight.h>
+
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "network.h"
+
+namespace neurons {
+
+// Architecture of a network and configuration of its optimizer, written as
+// text so networks can be built and trained without the editor.
+// One statement per line, with arguments separated by spaces and anything
+// after '#' ignored:
+//   node <name> <NodeType> [arguments...]
+//   link <input name> <output name>
+//   optimizer <optimizer name> [arguments...]
+// The DataNode is named "data" and is not declared. Arguments are those of
+// the node and optimizer dialogs of the editor, in the same order, with
+// booleans and pooling modes as numbers.
+struct NetworkSpec {
+  struct NodeSpec {
+    std::string name_;
+    NodeType type_;
+    std::vector<double> args_;
+  };
+  struct OptimizerSpec {
+    // Class name without the fl:: namespace, e.g. "AdamOptimizer"
+    std::string name_;
+    std::vector<double> args_;
+  };
+
+  std::vector<NodeSpec> nodes_;
+  // Input and output node names of every link
+  std::vector<std::pair<std::string, std::string>> links_;
+  OptimizerSpec optimizer_;
+};
+
+// Name of the DataNode in a NetworkSpec.
+const char* const kDataNodeName = "data";
+
+// Parse a NetworkSpec from input. Throws std::invalid_argument naming the
+// line of the first malformed statement, unknown node type, repeated node
+// name, or if there is not exactly one optimizer statement.
+NetworkSpec ParseNetworkSpec(std::istream& input);
+
+// Parse the NetworkSpec in the file at path. Throws std::runtime_error if
+// the file cannot be read, and as ParseNetworkSpec otherwise.
+NetworkSpec LoadNetworkSpec(const std::string& path);
+
+// Make the module of a node of the passed type from its arguments. The
+// editor's node dialogs make their modules here too, so both check the
+// arguments alike. Throws std::invalid_argument if the type has no module
+// or the arguments are invalid for it.
+std::unique_ptr<fl::Module> MakeModule(NodeType type,
+    const std::vector<double>& args);
+
+// Add the nodes and links of spec to network, which must already have a
+// DataNode. Throws std::invalid_argument if a module cannot be made, or a
+// link names an unknown node or is rejected.
+void BuildNetwork(const NetworkSpec& spec, Network& network);
+
+// Make the optimizer of spec for params, as the editor's Train Model dialog
+// also does. Throws std::invalid_argument if the optimizer is unknown or its
+// arguments are invalid.
+std::shared_ptr<fl::FirstOrderOptimizer> MakeOptimizer(
+    const NetworkSpec::OptimizerSpec& spec,
+    const std::vector<fl::Variable>& params);
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_NETWORK_SPEC_H_
@@ -2,22 +2,51 @@
 #ifndef FINALPROJECT_NEURONS_NETWORK_H
 #define FINALPROJECT_NEURONS_NETWORK_H
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "data-node.h"
+#include "graph-snapshot.h"
 #include "link.h"
 #include "module-node.h"
 #include "node.h"
+#include "slot-map.h"
 
 namespace neurons {
 
+// Outcome of Network::AddLink.
+enum LinkRejection { LinkAccepted, LinkNodeMissing, LinkCreatesCycle };
+
+// Get a description of the LinkRejection as an std::string
+std::string LinkRejectionToString(LinkRejection rejection);
+
 class Network {
 
  public:
 
-  // Retrieve std::deque of Nodes.
-  [[nodiscard]] NodeDeque& GetNodes();
-
-  // Retrieve std::deque of Links.
-  [[nodiscard]] std::deque<Link>& GetLinks();
+  // Retrieve std::deque of Nodes, in the order they were added.
+  // The deque is a view owned by the network and rebuilt on the first call
+  // after any AddNode, AddLink or Delete* call, which invalidates every
+  // reference and iterator into it. Hold on to the deque only while the
+  // network is unmodified; copy the Node pointers to keep them longer.
+  [[nodiscard]] const NodeDeque& GetNodes() const;
+
+  // Retrieve std::deque of Links, in the order they were added.
+  // The deque is a view owned by the network and rebuilt on the first call
+  // after any AddNode, AddLink or Delete* call, which invalidates every
+  // reference and iterator into it. Hold on to the deque only while the
+  // network is unmodified; use GetLinkHandle to keep a Link longer.
+  [[nodiscard]] const std::deque<Link>& GetLinks() const;
+
+  // Returns an index-based snapshot of the current nodes and links.
+  // The snapshot is built on first use after the network is modified and
+  // shared by later calls, so repeated graph queries do not rebuild it.
+  // Returned snapshots remain valid after the network is modified.
+  // Nodes in the snapshot carry the network's topological order.
+  [[nodiscard]] std::shared_ptr<const GraphSnapshot> GetSnapshot() const;
 
   // Add a ModuleNode to the network with a unique_ptr to an fl::Module.
   // Network will take ownership of the fl::Module pointer.
@@ -33,15 +62,59 @@ class Network {
                                 std::unique_ptr<fl::Dataset> test_set);
 
   // Add a Link to the network if the input and output form a valid Link.
+  // Links that would form a directed cycle are rejected.
   // Returns a pointer to the Link if successful. Otherwise, returns nullptr.
+  // The pointer is only valid until the network is next modified, use
+  // GetLinkHandle to keep a reference to the Link.
   Link* AddLink(const std::shared_ptr<Node>& input, const std::shared_ptr<Node>& output);
 
-  // Delete a Link from the network.
+  // Same as above, setting rejection to the reason the Link was not added,
+  // or to LinkAccepted if it was.
+  Link* AddLink(const std::shared_ptr<Node>& input,
+      const std::shared_ptr<Node>& output, LinkRejection& rejection);
+
+  // Delete the Link with the same ID, input and output from the network.
   void DeleteLink(const Link& link);
 
+  // Delete every Link with one of the passed link IDs from the network.
+  // IDs that are not in the network are ignored.
+  void DeleteLinks(const std::vector<size_t>& link_ids);
+
   // Delete a Node from the network.
   void DeleteNode(const Node& node);
 
+  // Delete every Node with one of the passed node IDs from the network,
+  // along with their Links. IDs that are not in the network are ignored.
+  // Runs in time linear in the number of IDs and deleted Links.
+  void DeleteNodes(const std::vector<size_t>& node_ids);
+
+  // Returns whether the Node is in the network.
+  [[nodiscard]] bool ContainsNode(const std::shared_ptr<Node>& node) const;
+
+  // Returns pointer to the Node with the passed node ID. If no node in the
+  // network has the node ID, returns nullptr.
+  [[nodiscard]] std::shared_ptr<Node> GetNode(size_t node_id) const;
+
+  // Returns a Handle to the Link with the passed link ID, which detects the
+  // Link being deleted. Throws std::out_of_range if no link in the network
+  // has the link ID.
+  [[nodiscard]] Handle GetLinkHandle(size_t link_id) const;
+
+  // Returns pointer to the Link of the Handle. If the Link has been deleted,
+  // returns nullptr. The pointer is only valid until the network is next
+  // modified, but the Handle remains safe to use.
+  [[nodiscard]] const Link* GetLink(const Handle& handle) const;
+
+  // Returns the number of connected components in the network, treating
+  // links as undirected. Returns 0 if the network has no nodes.
+  [[nodiscard]] size_t CountComponents() const;
+
+  // Returns the component ID of the node with the passed node ID. Two nodes
+  // have the same component ID if and only if they are connected.
+  // Component IDs are node IDs, and may change when the network is modified.
+  // Throws std::out_of_range if no node in the network has the node ID.
+  [[nodiscard]] size_t GetComponentId(size_t node_id) const;
+
   // Returns pointer to the data node of the network. If network does not have
   // a data node set, returns nullptr.
   [[nodiscard]] std::shared_ptr<DataNode> GetDataNode() const;
@@ -53,13 +126,82 @@ class Network {
  private:
 
   // Keep track of next unique ID for Nodes/Links.
-  size_t unique_id_;
-
-  // Deque of all the Node pointers in the network.
-  NodeDeque nodes_;
-
-  // Deque of all the Links in the network.
-  std::deque<Link> links_;
+  // Node IDs also seed the topological order, so they must only increase.
+  size_t unique_id_ = 0;
+
+  // Bookkeeping kept for every Node, so the graph can be updated
+  // incrementally rather than rescanned.
+  struct NodeRecord {
+    std::shared_ptr<Node> node_;
+    // Position of the node in a topological order of the network
+    size_t order_;
+    // Nodes this node links to, by link ID
+    std::unordered_map<size_t, Handle> successors_;
+    // Nodes that link to this node, by link ID
+    std::unordered_map<size_t, Handle> predecessors_;
+  };
+
+  // Records of every Node in the network, and their Handles by node ID.
+  SlotMap<NodeRecord> nodes_;
+  std::unordered_map<size_t, Handle> node_handles_;
+
+  // Every Link in the network, and their Handles by link ID.
+  SlotMap<Link> links_;
+  std::unordered_map<size_t, Handle> link_handles_;
+
+  // Views of nodes_ and links_ returned by GetNodes and GetLinks.
+  mutable NodeDeque node_view_;
+  mutable std::deque<Link> link_view_;
+  mutable bool node_view_stale_ = false;
+  mutable bool link_view_stale_ = false;
+
+  // The data node and the first loss node of the network, or nullptr.
+  std::shared_ptr<DataNode> data_node_;
+  std::shared_ptr<Node> loss_node_;
+
+  // Disjoint-set forest over positions in nodes_, tracking connected
+  // components.
+  struct ComponentRecord {
+    size_t parent_;
+    // Number of nodes in the tree rooted at this node
+    size_t size_;
+  };
+
+  // Component records, parallel to the values of nodes_. Updated as nodes
+  // and links are added. Deletions cannot be undone in a disjoint-set forest
+  // (and move values in nodes_), so they mark the forest stale and it is
+  // rebuilt from nodes_ on the next query.
+  mutable std::vector<ComponentRecord> components_;
+  mutable size_t component_count_ = 0;
+  mutable bool components_stale_ = false;
+
+  // Returns the root position of the position's component, halving paths.
+  size_t FindComponent(size_t position) const;
+
+  // Merges the components of the two positions by size.
+  void MergeComponents(size_t lhs, size_t rhs) const;
+
+  // Rebuilds components_ from nodes_ if it is stale.
+  void RefreshComponents() const;
+
+  // Add a record for the node, returning its Handle.
+  Handle AddRecord(const std::shared_ptr<Node>& node);
+
+  // Remove every Link with one of the passed link IDs, along with their
+  // entries in the records of their input and output nodes.
+  void RemoveLinks(const std::unordered_set<size_t>& link_ids);
+
+  // Updates the topological order for a new link from input to output using
+  // the Pearce-Kelly algorithm, only visiting nodes ordered between them.
+  // Returns false without changing the order if the link forms a cycle.
+  bool OrderLink(const Handle& input, const Handle& output);
+
+  // Marks everything derived from nodes_ and links_ as stale.
+  void MarkModified();
+
+  // Snapshot of nodes_ and links_, or nullptr if they have been modified
+  // since the last call to GetSnapshot.
+  mutable std::shared_ptr<const GraphSnapshot> snapshot_;
 
 };
 
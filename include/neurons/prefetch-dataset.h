@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_PREFETCH_DATASET_H_
+#define FINALPROJECT_NEURONS_PREFETCH_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "epoch-dataset.h"
+
+namespace neurons {
+
+// Dataset that retrieves and evaluates the samples after the one last
+// requested on worker threads, so they are ready when iteration reaches
+// them. Iterating in index order hits the prefetched samples; any other
+// access pattern falls back to retrieving the sample on the calling thread.
+class PrefetchDataset : public WrapperDataset {
+
+ public:
+
+  // How often requested samples were ready, for spotting when the consumer
+  // waits on data.
+  struct Counters {
+    // Samples requested through get()
+    size_t requests_;
+    // Requests whose sample was still being prepared by a worker
+    size_t starved_;
+    // Requests that were not prefetched, and so were served synchronously
+    size_t misses_;
+    // Total time spent waiting on workers or serving misses
+    double wait_seconds_;
+  };
+
+  // Public constructor. Prefetches up to queue_depth samples ahead using
+  // thread_count worker threads. If either is 0, samples are retrieved
+  // synchronously. Throws std::invalid_argument if dataset is null.
+  PrefetchDataset(std::shared_ptr<fl::Dataset> dataset,
+                  size_t thread_count, size_t queue_depth);
+
+  // Stops and joins the worker threads.
+  ~PrefetchDataset() override;
+
+  PrefetchDataset(const PrefetchDataset&) = delete;
+  PrefetchDataset& operator=(const PrefetchDataset&) = delete;
+
+  // Get the sample at idx, and start prefetching the ones after it.
+  [[nodiscard]] std::vector<af::array> get(int64_t idx) const override;
+
+  // Drops the prefetched samples, and waits for the workers to finish the
+  // ones in progress. Call before modifying the wrapped dataset.
+  void Drain();
+
+  // Drains, then begins the epoch on the wrapped dataset.
+  void BeginEpoch(size_t epoch) override;
+
+  // Get the counters since construction or the last ResetCounters().
+  [[nodiscard]] Counters GetCounters() const;
+
+  // Set every counter to zero.
+  void ResetCounters();
+
+ private:
+
+  typedef std::packaged_task<std::vector<af::array>()> Task;
+
+  // Schedules the samples after the back of the queue, up to queue_depth_.
+  // Requires mutex_ to be held.
+  void Refill(int64_t next) const;
+
+  // Takes tasks off the task queue until stopped.
+  void Work(int device);
+
+  size_t queue_depth_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable task_available_;
+  std::condition_variable task_finished_;
+  // Tasks picked up by a worker and not yet finished
+  size_t running_;
+  // Tasks not yet picked up by a worker
+  mutable std::deque<Task> tasks_;
+  // Sample indices and results of the scheduled tasks, in index order
+  mutable std::deque<std::pair<int64_t, std::future<std::vector<af::array>>>>
+      prefetched_;
+  mutable Counters counters_;
+  bool stopped_;
+
+};
+
+// Drains dataset and the PrefetchDatasets it wraps through WrapperDatasets,
+// if any.
+void DrainPrefetch(fl::Dataset& dataset);
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_PREFETCH_DATASET_H_
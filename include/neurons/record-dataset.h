@@ -0,0 +1,67 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_RECORD_DATASET_H_
+#define FINALPROJECT_NEURONS_RECORD_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+#include "record-source.h"
+
+namespace neurons {
+
+// Batched dataset of inputs and targets read from RecordSources as each
+// batch is retrieved, so only the batches in use are ever in memory.
+// Inputs are converted to (element + offset) * scale as f32. Integer
+// targets are served as s32, and floating point targets as they are.
+// Batches hold consecutive records. Input records of up to three dims are
+// laid out innermost first with the examples along dim 3, as ArrayFire
+// images are; scalar records are laid out along dim 0.
+class RecordDataset : public fl::Dataset {
+
+ public:
+
+  // Public constructor. Both sources must hold the same number of records
+  // of at most three dimensions. The last batch holds the remaining
+  // records, and may be smaller than batch_size. Throws
+  // std::invalid_argument if a source is null, the record counts do not
+  // match, a record has too many dimensions or batch_size is not positive.
+  RecordDataset(std::shared_ptr<const RecordSource> inputs,
+                std::shared_ptr<const RecordSource> targets,
+                dim_t batch_size, float offset, float scale);
+
+  // Get the number of batches.
+  [[nodiscard]] int64_t size() const override;
+
+  // Read the inputs and the targets of the batch at idx.
+  // Throws std::out_of_range if idx is not a batch index.
+  [[nodiscard]] std::vector<af::array> get(int64_t idx) const override;
+
+  // Batch the records by batch_size instead.
+  // Throws std::invalid_argument if batch_size is not positive.
+  void SetBatchSize(dim_t batch_size);
+
+  // Get the number of examples.
+  [[nodiscard]] dim_t GetExampleCount() const;
+
+  // Get the number of examples per batch.
+  [[nodiscard]] dim_t GetBatchSize() const;
+
+ private:
+
+  std::shared_ptr<const RecordSource> inputs_;
+  std::shared_ptr<const RecordSource> targets_;
+  dim_t batch_size_;
+  float offset_;
+  float scale_;
+
+};
+
+// Reads records [first, first + count) of source into an array laid out as
+// described for RecordDataset. Int8 elements are widened to s16, which is
+// the smallest signed type of ArrayFire.
+// Throws std::invalid_argument if the records have more than three dims.
+af::array ReadRecordArray(const RecordSource& source, size_t first,
+                          size_t count);
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_RECORD_DATASET_H_
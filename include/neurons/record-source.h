@@ -0,0 +1,116 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_RECORD_SOURCE_H_
+#define FINALPROJECT_NEURONS_RECORD_SOURCE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mapped-file.h"
+
+namespace neurons {
+
+// Types of the elements of records.
+enum class ElementType {
+  UInt8, Int8, Int16, Int32, Int64, Float32, Float64
+};
+
+// Get the size in bytes of one element of the passed type.
+size_t GetElementSize(ElementType type);
+
+// Sequence of equally shaped records, e.g. the images or the labels of a
+// dataset, that are read on demand instead of held in memory.
+class RecordSource {
+
+ public:
+
+  virtual ~RecordSource() = default;
+
+  // Get the shape of one record, outermost dimension first. Empty if the
+  // records are scalars.
+  [[nodiscard]] virtual const std::vector<size_t>& GetRecordShape() const = 0;
+
+  // Get the number of records.
+  [[nodiscard]] virtual size_t GetRecordCount() const = 0;
+
+  // Get the type of the record elements.
+  [[nodiscard]] virtual ElementType GetElementType() const = 0;
+
+  // Copies records [first, first + count) to out, row-major and in native
+  // byte order. out must hold count * GetRecordSize() bytes. Safe to call
+  // from several threads at once. Throws std::out_of_range if the records
+  // do not exist.
+  virtual void ReadRecords(size_t first, size_t count, void* out) const = 0;
+
+  // Get the size of one record in bytes.
+  [[nodiscard]] size_t GetRecordSize() const;
+
+};
+
+// RecordSource over a file of records stored back to back after a header.
+// The shape of the records is taken from the header where the format has
+// one. The file is mapped once, for the lifetime of the RecordFile, and its
+// pages are only read in as records are read, so files larger than memory
+// are streamed. No access pattern is advised, since batches may be read in
+// any order.
+class RecordFile : public RecordSource {
+
+ public:
+
+  // Opens an IDX file (http://yann.lecun.com/exdb/mnist/) of any element
+  // type. The outermost dimension counts the records. Throws
+  // std::runtime_error if the file cannot be read or is not a valid IDX
+  // file.
+  static std::unique_ptr<RecordFile> OpenIdx(const std::string& path);
+
+  // Opens a NumPy .npy file of a C-ordered array with a supported element
+  // type. The outermost dimension counts the records. Throws
+  // std::runtime_error if the file cannot be read or is not a supported
+  // .npy file.
+  static std::unique_ptr<RecordFile> OpenNpy(const std::string& path);
+
+  // Opens a headerless file of native byte order records of the passed
+  // shape, after header_size bytes that are skipped. The record count is
+  // inferred from the file size. Throws std::runtime_error if the file
+  // cannot be read or does not hold a whole number of records.
+  static std::unique_ptr<RecordFile> OpenRaw(const std::string& path,
+      ElementType type, const std::vector<size_t>& record_shape,
+      size_t header_size = 0);
+
+  [[nodiscard]] const std::vector<size_t>& GetRecordShape() const override;
+  [[nodiscard]] size_t GetRecordCount() const override;
+  [[nodiscard]] ElementType GetElementType() const override;
+  void ReadRecords(size_t first, size_t count, void* out) const override;
+
+  // Get the path of the file.
+  [[nodiscard]] const std::string& GetPath() const;
+
+ private:
+
+  // Maps the file. Throws std::runtime_error if it cannot be mapped or is
+  // shorter than the records.
+  RecordFile(std::string path, size_t data_offset, ElementType type,
+             std::vector<size_t> record_shape, size_t record_count,
+             bool swap_bytes);
+
+  std::string path_;
+  MappedFile file_;
+  // Byte offset of the first record
+  size_t data_offset_;
+  ElementType type_;
+  std::vector<size_t> record_shape_;
+  size_t record_count_;
+  // Whether the file byte order differs from the native one
+  bool swap_bytes_;
+
+};
+
+// Opens the record file at path, choosing the format by extension:
+// ".npy" files are NumPy arrays, anything else must be IDX.
+// Throws std::runtime_error if the file cannot be opened.
+std::unique_ptr<RecordFile> OpenRecordFile(const std::string& path);
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_RECORD_SOURCE_H_
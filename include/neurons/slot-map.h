@@ -0,0 +1,138 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_SLOT_MAP_H_
+#define FINALPROJECT_NEURONS_SLOT_MAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace neurons {
+
+// Stable reference to a value in a SlotMap. A Handle stays valid until its
+// value is erased. It then becomes stale and is never valid again, even if
+// its slot is reused, as every reuse increments the slot generation.
+struct Handle {
+  size_t index_;
+  size_t generation_;
+
+  bool operator==(const Handle& rhs) const {
+    return index_ == rhs.index_ && generation_ == rhs.generation_;
+  }
+
+  bool operator!=(const Handle& rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+// Generational slot map. Values are stored contiguously in no particular
+// order and referenced by Handles. Insert, Erase and Get run in O(1).
+// Erasing moves the last value into the erased value's position, so pointers
+// and positions are only valid until the next Insert or Erase.
+template <typename T>
+class SlotMap {
+
+ public:
+
+  // Insert a value and return its Handle.
+  Handle Insert(T value) {
+    size_t index;
+    if (free_slots_.empty()) {
+      index = slots_.size();
+      slots_.push_back({0, 0});
+    } else {
+      index = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    slots_.at(index).position_ = values_.size();
+    values_.push_back(std::move(value));
+    value_slots_.push_back(index);
+    return {index, slots_.at(index).generation_};
+  }
+
+  // Erase the value of the Handle.
+  // Returns false without erasing anything if the Handle is stale.
+  bool Erase(const Handle& handle) {
+    if (!Contains(handle)) {
+      return false;
+    }
+    Slot& slot = slots_.at(handle.index_);
+
+    // move the last value into the erased position
+    size_t last = values_.size() - 1;
+    if (slot.position_ != last) {
+      values_.at(slot.position_) = std::move(values_.at(last));
+      value_slots_.at(slot.position_) = value_slots_.at(last);
+      slots_.at(value_slots_.at(last)).position_ = slot.position_;
+    }
+    values_.pop_back();
+    value_slots_.pop_back();
+
+    ++slot.generation_;
+    free_slots_.push_back(handle.index_);
+    return true;
+  }
+
+  // Returns whether the Handle refers to a value in the map.
+  [[nodiscard]] bool Contains(const Handle& handle) const {
+    return handle.index_ < slots_.size() &&
+           slots_.at(handle.index_).generation_ == handle.generation_;
+  }
+
+  // Returns a pointer to the value of the Handle.
+  // Returns nullptr if the Handle is stale.
+  T* Get(const Handle& handle) {
+    return Contains(handle) ? &values_.at(slots_.at(handle.index_).position_)
+                            : nullptr;
+  }
+
+  const T* Get(const Handle& handle) const {
+    return Contains(handle) ? &values_.at(slots_.at(handle.index_).position_)
+                            : nullptr;
+  }
+
+  // Returns the position of the Handle's value in GetValues().
+  // The Handle must not be stale.
+  [[nodiscard]] size_t GetPosition(const Handle& handle) const {
+    return slots_.at(handle.index_).position_;
+  }
+
+  // Returns the Handle of the value at the passed position in GetValues().
+  [[nodiscard]] Handle GetHandle(size_t position) const {
+    size_t index = value_slots_.at(position);
+    return {index, slots_.at(index).generation_};
+  }
+
+  // Get the contiguous values in the map, in no particular order.
+  [[nodiscard]] const std::vector<T>& GetValues() const {
+    return values_;
+  }
+
+  // Get the number of values in the map.
+  [[nodiscard]] size_t Size() const {
+    return values_.size();
+  }
+
+ private:
+
+  struct Slot {
+    // Position of the slot's value in values_
+    size_t position_;
+    // Incremented whenever the slot's value is erased
+    size_t generation_;
+  };
+
+  std::vector<T> values_;
+
+  // Slot index of each value in values_
+  std::vector<size_t> value_slots_;
+
+  std::vector<Slot> slots_;
+
+  // Indices of slots without a value, reused before adding slots
+  std::vector<size_t> free_slots_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_SLOT_MAP_H_
@@ -0,0 +1,71 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+#ifndef FINALPROJECT_NEURONS_SYNTHETIC_DATASET_H_
+#define FINALPROJECT_NEURONS_SYNTHETIC_DATASET_H_
+
+#include <flashlight/flashlight.h>
+
+namespace neurons {
+
+// Batched dataset of generated f32 inputs and s32 class labels, for running
+// benchmarks and tests without data files. Batches are generated on the
+// device when retrieved, and depend only on the seed, the batch size and
+// the batch index, so every run sees the same data.
+// Each class has a random prototype input, and an example is the prototype
+// of its label plus normally distributed noise, so models can learn the
+// classes.
+class SyntheticDataset : public fl::Dataset {
+
+ public:
+
+  // Public constructor. Examples have the dims of example_dims, whose dim 3
+  // must be 1, and are batched along dim 3. The last batch holds the
+  // remaining examples, and may be smaller than batch_size. noise is the
+  // standard deviation of the noise added to the prototypes. Throws
+  // std::invalid_argument if an argument is out of range.
+  SyntheticDataset(const af::dim4& example_dims, int class_count,
+                   dim_t example_count, dim_t batch_size, float noise,
+                   uint64_t seed);
+
+  // Public constructor for another split of the classes of other, e.g. a
+  // validation set, of example_count examples generated from seed. seed
+  // should differ from the seeds of the other splits.
+  // Throws std::invalid_argument if example_count is negative.
+  SyntheticDataset(const SyntheticDataset& other, dim_t example_count,
+                   uint64_t seed);
+
+  // Get the number of batches.
+  [[nodiscard]] int64_t size() const override;
+
+  // Generate the inputs and the labels of the batch at idx.
+  // Throws std::out_of_range if idx is not a batch index.
+  [[nodiscard]] std::vector<af::array> get(int64_t idx) const override;
+
+  // Batch the examples by batch_size instead.
+  // Throws std::invalid_argument if batch_size is not positive.
+  void SetBatchSize(dim_t batch_size);
+
+  // Get the number of examples.
+  [[nodiscard]] dim_t GetExampleCount() const;
+
+  // Get the number of examples per batch.
+  [[nodiscard]] dim_t GetBatchSize() const;
+
+  // Get the number of classes.
+  [[nodiscard]] int GetClassCount() const;
+
+ private:
+
+  af::dim4 example_dims_;
+  int class_count_;
+  dim_t example_count_;
+  dim_t batch_size_;
+  float noise_;
+  uint64_t seed_;
+  // Prototype input of every class, along dim 3
+  af::array prototypes_;
+
+};
+
+}  // namespace neurons
+
+#endif  // FINALPROJECT_NEURONS_SYNTHETIC_DATASET_H_
@@ -2,11 +2,77 @@
 #ifndef FINALPROJECT_NEURONS_UTILITIES_H_
 #define FINALPROJECT_NEURONS_UTILITIES_H_
 
+#include <string>
+#include <vector>
+
 #include "link.h"
 #include "node.h"
 
+namespace neurons {
+
+class GraphSnapshot;
+
+}  // namespace neurons
+
 namespace neurons::utilities {
 
+// Requirements a graph must satisfy to be built into a NetworkContainer.
+enum ViolationType {
+  NullNode, DuplicateId, ForeignNode, MultipleComponents, DirectedCycle,
+  UnsatisfiedInput, UnsatisfiedOutput
+};
+
+// A requirement violated by a graph, with the IDs of the nodes and links
+// responsible for it.
+struct GraphViolation {
+  ViolationType type_;
+  std::vector<size_t> node_ids_;
+  std::vector<size_t> link_ids_;
+};
+
+// Get a description of the GraphViolation as an std::string
+std::string GraphViolationToString(const GraphViolation& violation);
+
+// Returns whether the node type is a loss node type (has no output)
+bool IsLossType(NodeType type);
+
+// Index-based adjacency list in compressed sparse row form. Nodes are
+// identified by their index in the NodeDeque the list was built from.
+// The neighbors of node i are targets_[offsets_[i]] to
+// targets_[offsets_[i + 1] - 1] in link order, and links_ holds the index of
+// the link forming each of those edges.
+struct AdjacencyList {
+  std::vector<size_t> offsets_;
+  std::vector<size_t> targets_;
+  std::vector<size_t> links_;
+
+  // Get the number of nodes in the list.
+  [[nodiscard]] size_t NodeCount() const;
+};
+
+// Returns an AdjacencyList over node_count nodes with an edge from
+// sources[i] to targets[i] for every link index i. Links with an endpoint
+// that is not a valid node index are skipped.
+AdjacencyList BuildAdjacencyList(size_t node_count,
+    const std::vector<size_t>& sources, const std::vector<size_t>& targets);
+
+// Returns an AdjacencyList with an edge from the input to the output of
+// every link, or from the output to the input if reverse is true.
+// Links with a node that is not in nodes are skipped.
+AdjacencyList BuildAdjacencyList(const NodeDeque& nodes,
+    const std::deque<Link>& links, bool reverse = false);
+
+// Returns the node indices of the AdjacencyList sorted topologically, in the
+// same order as TopologicalSort. Uses an explicit stack rather than
+// recursion, so arbitrarily deep graphs can be sorted.
+std::vector<size_t> TopologicalOrder(const AdjacencyList& adjacency);
+
+// Returns the strongly connected component of every node index, numbered
+// from 0 in topological order of the components. reverse must be the
+// reverse of adjacency. Uses Kosaraju's algorithm with explicit stacks.
+std::vector<size_t> StrongComponents(const AdjacencyList& adjacency,
+                                     const AdjacencyList& reverse);
+
 // Returns whether node IDs and link IDs are all unique
 // and link input and outputs correspond to nodes in the passed NodeDeque.
 bool NodesAndLinksConsistent(const NodeDeque& nodes,
@@ -19,6 +85,9 @@ bool NodesAndLinksConsistent(const NodeDeque& nodes,
 NodeDeque TopologicalSort(const NodeDeque& nodes,
     const std::deque<Link>& links);
 
+// Same as above, reusing the adjacency of an existing GraphSnapshot.
+NodeDeque TopologicalSort(const GraphSnapshot& graph);
+
 // Returns whether the graph constructed by the passed links contains
 // a directed cycle. Note: a directed cycle, as used here, must have > 1 nodes.
 bool ContainsDirectedCycle(const NodeDeque& nodes,
@@ -36,6 +105,18 @@ bool AreNodeInputsSatisfied(const NodeDeque& nodes,
 bool AreNodeOutputsSatisfied(const NodeDeque& nodes,
                             const std::deque<Link>& links);
 
+// Checks every graph requirement in a single linear-time pass and returns
+// all violations found, ordered by ViolationType. Returns an empty vector
+// if the graph is valid. Requirements are the same as the functions above:
+// consistent nodes and links, exactly one connected component, no directed
+// cycle, and satisfied node inputs and outputs.
+// Links with a node outside the graph only produce a ForeignNode violation.
+std::vector<GraphViolation> ValidateGraph(const NodeDeque& nodes,
+                                          const std::deque<Link>& links);
+
+// Same as above, reusing the adjacency of an existing GraphSnapshot.
+std::vector<GraphViolation> ValidateGraph(const GraphSnapshot& graph);
+
 }  // namespace neurons::utilities
 
 #endif  // FINALPROJECT_NEURONS_UTILITIES_H_
@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/augment-dataset.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace neurons {
+
+namespace {
+
+// Returns a random value in [-1, 1) per example, shaped (1, 1, 1, count).
+af::array Symmetric(dim_t count, af::randomEngine& engine) {
+  return af::randu(af::dim4(1, 1, 1, count), f32, engine) * 2 - 1;
+}
+
+// Returns an elastic displacement field of the passed dims: uniform noise
+// smoothed by a Gaussian kernel, then scaled by alpha.
+af::array Displacement(const af::dim4& dims, float alpha, float sigma,
+                       af::randomEngine& engine) {
+  af::array field = af::randu(dims, f32, engine) * 2 - 1;
+  if (sigma > 0) {
+    // the kernel spans three standard deviations each way
+    auto radius = static_cast<int>(std::ceil(3 * sigma));
+    af::array kernel = af::gaussianKernel(2 * radius + 1, 2 * radius + 1,
+                                          sigma, sigma);
+    field = af::convolve2(field, kernel);
+  }
+  return field * alpha;
+}
+
+}  // namespace
+
+AugmentDataset::AugmentDataset(std::shared_ptr<fl::Dataset> dataset,
+    const Augmentation& augmentation, uint64_t seed)
+    : WrapperDataset(std::move(dataset)), augmentation_(augmentation),
+      seed_(seed), epoch_(0), enabled_(true) {
+  if (augmentation_.max_shift_ < 0 || augmentation_.max_rotation_ < 0 ||
+      augmentation_.elastic_alpha_ < 0 || augmentation_.elastic_sigma_ < 0 ||
+      augmentation_.noise_ < 0) {
+    throw std::invalid_argument("Augmentation amounts must not be negative.");
+  }
+}
+
+std::vector<af::array> AugmentDataset::get(int64_t idx) const {
+  std::vector<af::array> sample = dataset_->get(idx);
+  if (!enabled_ || sample.empty()) {
+    return sample;
+  }
+  // counter-based engine, so nearby seeds give unrelated streams
+  af::randomEngine engine(AF_RANDOM_ENGINE_DEFAULT,
+      seed_ + 0x9E3779B97F4A7C15ull * (epoch_ + 1) +
+      static_cast<uint64_t>(idx));
+  sample.front() = Augment(sample.front(), augmentation_, engine);
+  return sample;
+}
+
+void AugmentDataset::BeginEpoch(size_t epoch) {
+  epoch_ = epoch;
+  WrapperDataset::BeginEpoch(epoch);
+}
+
+void AugmentDataset::SetEnabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+bool AugmentDataset::IsEnabled() const {
+  return enabled_;
+}
+
+const Augmentation& AugmentDataset::GetAugmentation() const {
+  return augmentation_;
+}
+
+af::array Augment(const af::array& images, const Augmentation& augmentation,
+                  af::randomEngine& engine) {
+  af::array result = images.as(f32);
+  const dim_t width = images.dims(0);
+  const dim_t height = images.dims(1);
+  const dim_t count = images.dims(3);
+
+  bool geometric = augmentation.max_shift_ > 0 ||
+                   augmentation.max_rotation_ > 0 ||
+                   augmentation.elastic_alpha_ > 0;
+  if (geometric && width > 1 && height > 1) {
+    // every output pixel samples the input at the inverse of the distortion
+    // of its coordinates, measured from the image center
+    af::dim4 grid(width, height, 1, count);
+    af::array x = af::range(grid, 0, f32) - static_cast<float>(width - 1) / 2;
+    af::array y = af::range(grid, 1, f32) - static_cast<float>(height - 1) / 2;
+
+    if (augmentation.max_shift_ > 0) {
+      x -= af::tile(Symmetric(count, engine) * augmentation.max_shift_,
+                    static_cast<unsigned>(width),
+                    static_cast<unsigned>(height));
+      y -= af::tile(Symmetric(count, engine) * augmentation.max_shift_,
+                    static_cast<unsigned>(width),
+                    static_cast<unsigned>(height));
+    }
+    if (augmentation.max_rotation_ > 0) {
+      af::array angle = af::tile(
+          Symmetric(count, engine) * augmentation.max_rotation_,
+          static_cast<unsigned>(width), static_cast<unsigned>(height));
+      af::array cosine = af::cos(angle);
+      af::array sine = af::sin(angle);
+      af::array rotated_x = cosine * x + sine * y;
+      y = cosine * y - sine * x;
+      x = rotated_x;
+    }
+    if (augmentation.elastic_alpha_ > 0) {
+      x += Displacement(grid, augmentation.elastic_alpha_,
+                        augmentation.elastic_sigma_, engine);
+      y += Displacement(grid, augmentation.elastic_alpha_,
+                        augmentation.elastic_sigma_, engine);
+    }
+
+    // back to pixel coordinates, clamped so the edges are repeated
+    x = af::clamp(x + static_cast<float>(width - 1) / 2, 0.0,
+                  static_cast<double>(width - 1));
+    y = af::clamp(y + static_cast<float>(height - 1) / 2, 0.0,
+                  static_cast<double>(height - 1));
+    // every channel is sampled at the same coordinates
+    auto channels = static_cast<unsigned>(images.dims(2));
+    result = af::approx2(result, af::tile(x, 1, 1, channels),
+                         af::tile(y, 1, 1, channels), AF_INTERP_BILINEAR);
+  }
+
+  if (augmentation.noise_ > 0) {
+    result += af::randn(result.dims(), f32, engine) * augmentation.noise_;
+  }
+  return result;
+}
+
+}  // namespace neurons
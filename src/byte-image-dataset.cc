@@ -0,0 +1,150 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/byte-image-dataset.h>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace neurons {
+
+namespace {
+
+// splitmix64 step, which turns consecutive seeds into unrelated ones.
+uint64_t Mix(uint64_t value) {
+  value += 0x9E3779B97F4A7C15ull;
+  value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27u)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31u);
+}
+
+// Returns a permutation of [begin, end). Uses a Fisher-Yates shuffle on
+// std::mt19937_64, whose output is fixed by the standard, so the result is
+// the same on every platform, unlike std::shuffle.
+std::vector<int32_t> Permutation(dim_t begin, dim_t end, uint64_t seed) {
+  std::vector<int32_t> order(static_cast<size_t>(end - begin));
+  for (size_t i = 0; i < order.size(); ++i) {
+    order.at(i) = static_cast<int32_t>(begin + static_cast<dim_t>(i));
+  }
+  std::mt19937_64 engine(seed);
+  for (size_t i = order.size(); i > 1; --i) {
+    std::swap(order.at(i - 1), order.at(engine() % i));
+  }
+  return order;
+}
+
+}  // namespace
+
+ByteImageDataset::ByteImageDataset(af::array images, af::array labels,
+    dim_t batch_size, float offset, float scale)
+    : storage_(std::make_shared<const Storage>(
+          Storage{std::move(images), std::move(labels)})),
+      begin_(0), end_(0), batch_size_(batch_size), offset_(offset),
+      scale_(scale), shuffle_(false), seed_(0), epoch_(0) {
+  if (storage_->images_.type() != u8) {
+    throw std::invalid_argument("Dataset images must be unsigned bytes.");
+  }
+  if (storage_->images_.dims(3) != storage_->labels_.dims(0)) {
+    throw std::invalid_argument("Dataset example counts do not match.");
+  }
+  if (batch_size_ <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+  end_ = GetStorageSize();
+}
+
+ByteImageDataset::ByteImageDataset(const ByteImageDataset& other,
+    dim_t begin, dim_t end)
+    : storage_(other.storage_), begin_(0), end_(0),
+      batch_size_(other.batch_size_), offset_(other.offset_),
+      scale_(other.scale_), shuffle_(false), seed_(0), epoch_(0) {
+  SetRange(begin, end);
+}
+
+int64_t ByteImageDataset::size() const {
+  return (GetExampleCount() + batch_size_ - 1) / batch_size_;
+}
+
+std::vector<af::array> ByteImageDataset::get(int64_t idx) const {
+  if (idx < 0 || idx >= size()) {
+    throw std::out_of_range("Dataset batch index out of range.");
+  }
+  dim_t begin = begin_ + idx * batch_size_;
+  dim_t end = std::min(begin + batch_size_, end_) - 1;
+  af::seq positions(static_cast<double>(begin), static_cast<double>(end));
+
+  af::array inputs;
+  af::array targets;
+  if (order_.isempty()) {
+    inputs = storage_->images_(af::span, af::span, af::span, positions);
+    targets = storage_->labels_(positions);
+  } else {
+    // gather the batch's examples into one contiguous batch
+    af::array examples = order_(positions - static_cast<double>(begin_));
+    inputs = storage_->images_(af::span, af::span, af::span, examples);
+    targets = storage_->labels_(examples);
+  }
+  // ArrayFire fuses the cast and rescale into one kernel over the batch
+  inputs = (inputs.as(f32) + offset_) * scale_;
+  return {inputs, targets};
+}
+
+void ByteImageDataset::SetRange(dim_t begin, dim_t end) {
+  if (begin < 0 || begin > end || end > GetStorageSize()) {
+    throw std::invalid_argument("Dataset range is out of bounds.");
+  }
+  begin_ = begin;
+  end_ = end;
+  // the permutation must cover the new range
+  BeginEpoch(epoch_);
+}
+
+void ByteImageDataset::SetBatchSize(dim_t batch_size) {
+  if (batch_size <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+  batch_size_ = batch_size;
+}
+
+void ByteImageDataset::EnableShuffle(uint64_t seed) {
+  shuffle_ = true;
+  seed_ = seed;
+  BeginEpoch(0);
+}
+
+void ByteImageDataset::DisableShuffle() {
+  shuffle_ = false;
+  order_ = af::array();
+}
+
+void ByteImageDataset::BeginEpoch(size_t epoch) {
+  epoch_ = epoch;
+  if (!shuffle_) {
+    return;
+  }
+  std::vector<int32_t> order =
+      Permutation(begin_, end_, Mix(seed_ ^ Mix(epoch)));
+  order_ = af::array(static_cast<dim_t>(order.size()), order.data());
+}
+
+bool ByteImageDataset::SharesStorage(const ByteImageDataset& other) const {
+  return storage_ == other.storage_;
+}
+
+dim_t ByteImageDataset::GetStorageSize() const {
+  return storage_->images_.dims(3);
+}
+
+dim_t ByteImageDataset::GetRangeBegin() const {
+  return begin_;
+}
+
+dim_t ByteImageDataset::GetExampleCount() const {
+  return end_ - begin_;
+}
+
+dim_t ByteImageDataset::GetBatchSize() const {
+  return batch_size_;
+}
+
+}  // namespace neurons
@@ -0,0 +1,100 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/classification-metrics.h>
+
+#include <stdexcept>
+
+namespace neurons {
+
+ClassificationMetrics::ClassificationMetrics(int class_count)
+    : class_count_(class_count) {
+  if (class_count_ <= 0) {
+    throw std::invalid_argument("Class count must be positive.");
+  }
+  Reset();
+}
+
+void ClassificationMetrics::Add(const af::array& outputs,
+    const af::array& targets, const af::array& loss) {
+  if (outputs.dims(0) != class_count_ ||
+      outputs.dims(1) != targets.elements() || loss.elements() != 1) {
+    throw std::invalid_argument("Metrics batch dims do not match.");
+  }
+  dim_t count = targets.elements();
+  if (count == 0) {
+    return;
+  }
+  // a target outside the classes would be counted into the wrong cell.
+  // only this flag is read back; the predictions are always in range
+  af::array flat_targets = af::flat(targets);
+  if (af::anyTrue<bool>(flat_targets < 0 || flat_targets >= class_count_)) {
+    throw std::invalid_argument("Metrics target is not a class.");
+  }
+
+  // the prediction is the class of the highest score
+  af::array scores, predictions;
+  af::max(scores, predictions, outputs, 0);
+
+  // count every (target, prediction) pair into its confusion matrix cell
+  auto cells = static_cast<unsigned>(class_count_ * class_count_);
+  af::array cell = flat_targets.as(u32) * class_count_ +
+                   af::flat(predictions).as(u32);
+  confusion_ += af::histogram(cell, cells, 0, cells);
+  loss_sum_ += af::flat(loss).as(f32) * static_cast<float>(count);
+  // evaluate now, so the totals do not build up one long JIT kernel
+  af::eval(confusion_, loss_sum_);
+}
+
+ClassificationMetrics::Results ClassificationMetrics::Read() const {
+  auto classes = static_cast<size_t>(class_count_);
+  std::vector<unsigned> counts(classes * classes);
+  float loss_sum = 0;
+  // the first read waits for the device, the second only copies
+  confusion_.host(counts.data());
+  loss_sum_.host(&loss_sum);
+
+  Results results = {0, 0, 0, std::vector<size_t>(counts.begin(),
+      counts.end()), std::vector<double>(classes),
+      std::vector<double>(classes)};
+  size_t correct = 0;
+  std::vector<size_t> predicted(classes);
+  std::vector<size_t> actual(classes);
+  for (size_t target = 0; target < classes; ++target) {
+    for (size_t prediction = 0; prediction < classes; ++prediction) {
+      size_t count = results.confusion_.at(target * classes + prediction);
+      results.example_count_ += count;
+      predicted.at(prediction) += count;
+      actual.at(target) += count;
+    }
+    correct += results.confusion_.at(target * classes + target);
+  }
+
+  for (size_t c = 0; c < classes; ++c) {
+    auto hits = static_cast<double>(results.confusion_.at(c * classes + c));
+    if (predicted.at(c) > 0) {
+      results.precision_.at(c) = hits / static_cast<double>(predicted.at(c));
+    }
+    if (actual.at(c) > 0) {
+      results.recall_.at(c) = hits / static_cast<double>(actual.at(c));
+    }
+  }
+  if (results.example_count_ > 0) {
+    auto examples = static_cast<double>(results.example_count_);
+    results.loss_ = loss_sum / examples;
+    results.error_ =
+        100.0 * static_cast<double>(results.example_count_ - correct) /
+        examples;
+  }
+  return results;
+}
+
+void ClassificationMetrics::Reset() {
+  confusion_ = af::constant(0, class_count_ * class_count_, u32);
+  loss_sum_ = af::constant(0, 1, f32);
+}
+
+int ClassificationMetrics::GetClassCount() const {
+  return class_count_;
+}
+
+}  // namespace neurons
@@ -1,10 +1,43 @@
 // Copyright (c) 2020 Simon Liu. All rights reserved.
 
 #include <flashlight/flashlight.h>
+#include <neurons/augment-dataset.h>
+#include <neurons/byte-image-dataset.h>
 #include <neurons/data-node.h>
+#include <neurons/epoch-dataset.h>
+#include <neurons/prefetch-dataset.h>
+#include <neurons/record-dataset.h>
+#include <neurons/synthetic-dataset.h>
+
+#include <cmath>
+#include <functional>
 
 namespace neurons {
 
+namespace {
+
+// Returns a function that rebatches the dataset batching the examples
+// under dataset, or an empty function if it is not of a type that can be
+// rebatched.
+std::function<void(dim_t)> FindRebatch(fl::Dataset& dataset) {
+  if (auto* images = FindDataset<ByteImageDataset>(dataset)) {
+    return [images](dim_t batch_size) { images->SetBatchSize(batch_size); };
+  }
+  if (auto* records = FindDataset<RecordDataset>(dataset)) {
+    return [records](dim_t batch_size) {
+      records->SetBatchSize(batch_size);
+    };
+  }
+  if (auto* synthetic = FindDataset<SyntheticDataset>(dataset)) {
+    return [synthetic](dim_t batch_size) {
+      synthetic->SetBatchSize(batch_size);
+    };
+  }
+  return {};
+}
+
+}  // namespace
+
 DataNode::DataNode(size_t id, std::unique_ptr<fl::Dataset> train_set,
          std::unique_ptr<fl::Dataset> valid_set,
          std::unique_ptr<fl::Dataset> test_set) : Node(id, Dataset) {
@@ -18,4 +51,56 @@ std::string DataNode::prettyString() const {
   return "Dataset";
 }
 
+void DataNode::BeginEpoch(size_t epoch) {
+  neurons::BeginEpoch(*train_dataset_, epoch);
+  neurons::BeginEpoch(*valid_dataset_, epoch);
+  neurons::BeginEpoch(*test_dataset_, epoch);
+}
+
+bool DataNode::SetValidationSplit(double fraction) {
+  auto* train = FindDataset<ByteImageDataset>(*train_dataset_);
+  auto* valid = FindDataset<ByteImageDataset>(*valid_dataset_);
+  if (train == nullptr || valid == nullptr || !train->SharesStorage(*valid) ||
+      !(fraction >= 0 && fraction < 1)) {
+    return false;
+  }
+  dim_t examples = train->GetStorageSize();
+  auto valid_examples = static_cast<dim_t>(
+      std::floor(fraction * static_cast<double>(examples)));
+
+  DrainPrefetch(*train_dataset_);
+  DrainPrefetch(*valid_dataset_);
+  valid->SetRange(0, valid_examples);
+  train->SetRange(valid_examples, examples);
+  return true;
+}
+
+bool DataNode::SetBatchSizes(dim_t train_batch_size, dim_t eval_batch_size) {
+  auto train = FindRebatch(*train_dataset_);
+  auto valid = FindRebatch(*valid_dataset_);
+  auto test = FindRebatch(*test_dataset_);
+  if (!train || !valid || !test ||
+      train_batch_size <= 0 || eval_batch_size <= 0) {
+    return false;
+  }
+
+  DrainPrefetch(*train_dataset_);
+  DrainPrefetch(*valid_dataset_);
+  DrainPrefetch(*test_dataset_);
+  train(train_batch_size);
+  valid(eval_batch_size);
+  test(eval_batch_size);
+  return true;
+}
+
+bool DataNode::SetAugmentation(bool enabled) {
+  auto* augment = FindDataset<AugmentDataset>(*train_dataset_);
+  if (augment == nullptr) {
+    return false;
+  }
+  DrainPrefetch(*train_dataset_);
+  augment->SetEnabled(enabled);
+  return true;
+}
+
 }  // namespace neurons
\ No newline at end of file
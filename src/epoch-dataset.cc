@@ -0,0 +1,35 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/epoch-dataset.h>
+
+#include <stdexcept>
+
+namespace neurons {
+
+WrapperDataset::WrapperDataset(std::shared_ptr<fl::Dataset> dataset)
+    : dataset_(std::move(dataset)) {
+  if (dataset_ == nullptr) {
+    throw std::invalid_argument("Wrapped dataset must not be null.");
+  }
+}
+
+int64_t WrapperDataset::size() const {
+  return dataset_->size();
+}
+
+void WrapperDataset::BeginEpoch(size_t epoch) {
+  neurons::BeginEpoch(*dataset_, epoch);
+}
+
+const std::shared_ptr<fl::Dataset>& WrapperDataset::GetDataset() const {
+  return dataset_;
+}
+
+void BeginEpoch(fl::Dataset& dataset, size_t epoch) {
+  auto* epoch_dataset = dynamic_cast<EpochDataset*>(&dataset);
+  if (epoch_dataset != nullptr) {
+    epoch_dataset->BeginEpoch(epoch);
+  }
+}
+
+}  // namespace neurons
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include "neurons/graph-snapshot.h"
+
+#include <utility>
+
+namespace neurons {
+
+GraphSnapshot::GraphSnapshot(const NodeDeque& nodes,
+    const std::deque<Link>& links) : GraphSnapshot(nodes, links, {}) {
+  order_ = utilities::TopologicalOrder(out_edges_);
+  known_acyclic_ = false;
+}
+
+GraphSnapshot::GraphSnapshot(const NodeDeque& nodes,
+    const std::deque<Link>& links, std::vector<size_t> order)
+    : nodes_(nodes), links_(links), order_(std::move(order)),
+      known_acyclic_(true) {
+
+  // resolve nodes by address, as we don't trust node IDs
+  std::unordered_map<const Node*, size_t> addresses;
+  for (size_t node = 0; node < nodes_.size(); ++node) {
+    if (nodes_.at(node) == nullptr) {
+      continue;
+    }
+    addresses.insert({nodes_.at(node).get(), node});
+    node_indices_.insert({nodes_.at(node)->GetId(), node});
+  }
+
+  link_inputs_.assign(links_.size(), nodes_.size());
+  link_outputs_.assign(links_.size(), nodes_.size());
+  for (size_t link = 0; link < links_.size(); ++link) {
+    auto input = addresses.find(links_.at(link).input_.get());
+    auto output = addresses.find(links_.at(link).output_.get());
+    if (input != addresses.end()) {
+      link_inputs_.at(link) = input->second;
+    }
+    if (output != addresses.end()) {
+      link_outputs_.at(link) = output->second;
+    }
+  }
+
+  out_edges_ = utilities::BuildAdjacencyList(nodes_.size(),
+      link_inputs_, link_outputs_);
+  in_edges_ = utilities::BuildAdjacencyList(nodes_.size(),
+      link_outputs_, link_inputs_);
+}
+
+const NodeDeque& GraphSnapshot::GetNodes() const {
+  return nodes_;
+}
+
+const std::deque<Link>& GraphSnapshot::GetLinks() const {
+  return links_;
+}
+
+size_t GraphSnapshot::GetNodeIndex(size_t node_id) const {
+  auto index = node_indices_.find(node_id);
+  return index == node_indices_.end() ? nodes_.size() : index->second;
+}
+
+size_t GraphSnapshot::GetLinkInput(size_t link) const {
+  return link_inputs_.at(link);
+}
+
+size_t GraphSnapshot::GetLinkOutput(size_t link) const {
+  return link_outputs_.at(link);
+}
+
+const utilities::AdjacencyList& GraphSnapshot::GetOutEdges() const {
+  return out_edges_;
+}
+
+const utilities::AdjacencyList& GraphSnapshot::GetInEdges() const {
+  return in_edges_;
+}
+
+const std::vector<size_t>& GraphSnapshot::GetTopologicalOrder() const {
+  return order_;
+}
+
+bool GraphSnapshot::IsKnownAcyclic() const {
+  return known_acyclic_;
+}
+
+}  // namespace neurons
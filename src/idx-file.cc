@@ -0,0 +1,69 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include "neurons/idx-file.h"
+
+#include <stdexcept>
+
+namespace neurons {
+
+namespace {
+
+// IDX type code of unsigned byte elements
+const unsigned char kUnsignedByte = 0x08;
+// Bytes before the dimension sizes: two zero bytes, type code, dim count
+const size_t kMagicSize = 4;
+const size_t kDimSize = 4;
+
+// Reads a big-endian 32-bit unsigned integer.
+size_t ReadBigEndian(const unsigned char* bytes) {
+  return (size_t(bytes[0]) << 24u) | (size_t(bytes[1]) << 16u) |
+         (size_t(bytes[2]) << 8u) | size_t(bytes[3]);
+}
+
+}  // namespace
+
+IdxFile::IdxFile(const std::string& path)
+    // the elements are copied out front to back
+    : file_(path, MappedFile::Access::Sequential), element_count_(0) {
+  const unsigned char* bytes = file_.GetData();
+  size_t size = file_.GetSize();
+  if (size < kMagicSize || bytes[0] != 0 || bytes[1] != 0) {
+    throw std::runtime_error("[IdxFile] Not an IDX file: " + path);
+  }
+  if (bytes[2] != kUnsignedByte) {
+    throw std::runtime_error("[IdxFile] Elements are not unsigned bytes: " +
+                             path);
+  }
+
+  size_t dim_count = bytes[3];
+  size_t header_size = kMagicSize + dim_count * kDimSize;
+  if (size < header_size) {
+    throw std::runtime_error("[IdxFile] Truncated header: " + path);
+  }
+  element_count_ = 1;
+  for (size_t i = 0; i < dim_count; ++i) {
+    dims_.push_back(ReadBigEndian(bytes + kMagicSize + i * kDimSize));
+    element_count_ *= dims_.back();
+  }
+  if (size - header_size < element_count_) {
+    throw std::runtime_error("[IdxFile] Truncated data: " + path);
+  }
+}
+
+const std::vector<size_t>& IdxFile::GetDims() const {
+  return dims_;
+}
+
+size_t IdxFile::GetElementCount() const {
+  return element_count_;
+}
+
+const unsigned char* IdxFile::GetData() const {
+  return file_.GetData() + kMagicSize + dims_.size() * kDimSize;
+}
+
+const MappedFile& IdxFile::GetFile() const {
+  return file_;
+}
+
+}  // namespace neurons
@@ -6,8 +6,8 @@
 
 namespace neurons::adapter {
 
-LinkAdapter::LinkAdapter(Link& link) {
-  link_ = &link;
+LinkAdapter::LinkAdapter(const Link& link, const Handle& handle) {
+  handle_ = handle;
 
   id_ = kIdMultiplier * link.GetId();
   // will throw exception if output_ or input_ is nullptr
@@ -15,11 +15,12 @@ LinkAdapter::LinkAdapter(Link& link) {
   start_id_ = kIdMultiplier * link.input_->GetId() + 2;
 }
 
-std::vector<LinkAdapter> BuildLinkAdapters(std::deque<Link>& links) {
+std::vector<LinkAdapter> BuildLinkAdapters(const Network& network) {
+  const auto& links = network.GetLinks();
   auto adapters = std::vector<LinkAdapter>();
   adapters.reserve(links.size());
-  for (auto& link : links) {
-    adapters.emplace_back(link);
+  for (const auto& link : links) {
+    adapters.emplace_back(link, network.GetLinkHandle(link.GetId()));
   }
   return adapters;
 }
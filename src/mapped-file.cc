@@ -0,0 +1,172 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include "neurons/mapped-file.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace neurons {
+
+MappedFile::MappedFile(const std::string& path, Access access)
+    : MappedFile(path, 0, std::numeric_limits<size_t>::max(), access) {}
+
+MappedFile::MappedFile(const std::string& path, size_t offset, size_t length,
+                       Access access)
+    : data_(nullptr), size_(0), file_size_(0), mapping_(nullptr),
+      mapping_size_(0), handle_(nullptr) {
+  Map(path, offset, length, access);
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      file_size_(std::exchange(other.file_size_, 0)),
+      mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)),
+      handle_(std::exchange(other.handle_, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    file_size_ = std::exchange(other.file_size_, 0);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    mapping_size_ = std::exchange(other.mapping_size_, 0);
+    handle_ = std::exchange(other.handle_, nullptr);
+  }
+  return *this;
+}
+
+const unsigned char* MappedFile::GetData() const {
+  return data_;
+}
+
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+size_t MappedFile::GetFileSize() const {
+  return file_size_;
+}
+
+void MappedFile::Map(const std::string& path, size_t offset, size_t length,
+                     Access access) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("[MappedFile] Can't open " + path);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error("[MappedFile] Can't read size of " + path);
+  }
+  file_size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error("[MappedFile] Can't open " + path);
+  }
+  struct stat file_stat {};
+  if (fstat(file, &file_stat) != 0) {
+    close(file);
+    throw std::runtime_error("[MappedFile] Can't read size of " + path);
+  }
+  file_size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+
+  if (offset > file_size_) {
+#ifdef _WIN32
+    CloseHandle(file);
+#else
+    close(file);
+#endif
+    throw std::runtime_error("[MappedFile] Offset past the end of " + path);
+  }
+  size_ = std::min(length, file_size_ - offset);
+
+  if (size_ > 0) {
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    size_t granularity = system_info.dwAllocationGranularity;
+    size_t start = offset / granularity * granularity;
+    mapping_size_ = size_ + (offset - start);
+    handle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (handle_ != nullptr) {
+      mapping_ = MapViewOfFile(handle_, FILE_MAP_READ,
+          static_cast<DWORD>(static_cast<uint64_t>(start) >> 32u),
+          static_cast<DWORD>(start & 0xFFFFFFFFu), mapping_size_);
+    }
+    // views take no access advice
+    static_cast<void>(access);
+#else
+    // mappings must start at a page boundary
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset / page_size * page_size;
+    mapping_size_ = size_ + (offset - start);
+    void* mapping = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE,
+                         file, static_cast<off_t>(start));
+    if (mapping != MAP_FAILED) {
+      mapping_ = mapping;
+      if (access == Access::Sequential) {
+        madvise(mapping, mapping_size_, MADV_SEQUENTIAL);
+      } else if (access == Access::Random) {
+        madvise(mapping, mapping_size_, MADV_RANDOM);
+      }
+    }
+#endif
+    if (mapping_ != nullptr) {
+      data_ = static_cast<const unsigned char*>(mapping_) + (offset - start);
+    }
+  }
+#ifdef _WIN32
+  CloseHandle(file);
+#else
+  // the mapping stays valid after the descriptor is closed
+  close(file);
+#endif
+  if (size_ > 0 && data_ == nullptr) {
+    Close();
+    throw std::runtime_error("[MappedFile] Can't map " + path);
+  }
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+  if (mapping_ != nullptr) {
+    UnmapViewOfFile(mapping_);
+  }
+  if (handle_ != nullptr) {
+    CloseHandle(handle_);
+  }
+#else
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  handle_ = nullptr;
+}
+
+}  // namespace neurons
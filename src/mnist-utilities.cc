@@ -2,77 +2,184 @@
 
 #include <iomanip>
 
+#include "neurons/augment-dataset.h"
+#include "neurons/byte-image-dataset.h"
+#include "neurons/classification-metrics.h"
+#include "neurons/idx-file.h"
+#include "neurons/prefetch-dataset.h"
+#include "neurons/record-dataset.h"
+#include "neurons/synthetic-dataset.h"
+
 // MNIST-specific dataloading and training functions below.
 // All methods from this file are derived from MNIST flashlight example:
 // https://github.com/facebookresearch/flashlight/blob/master/examples/Mnist.cpp
 
 namespace neurons::mnist_utilities {
 
-size_t read_int(std::ifstream& f) {
-  size_t d = 0;
-  size_t c;
-  for (size_t i = 0; i < sizeof(int); i++) {
-    c = 0;
-    f.read((char*)&c, 1);
-    d |= (c << (8 * (sizeof(int) - i - 1)));
+const size_t kImSize = kImDim * kImDim;
+// Seed of the train set shuffle, fixed so runs are reproducible
+const uint64_t kShuffleSeed = 126;
+// Seed of the train set augmentation
+const uint64_t kAugmentSeed = 127;
+// Distortions of the MNIST train digits: small shifts and rotations, and
+// the elastic distortion of Simard et al. (2003)
+const Augmentation kMnistAugmentation = {2.0f, 0.15f, 34.0f, 4.0f, 0.02f};
+
+// Maps the IDX file and checks that its dimensions are dims.
+IdxFile open_data(const std::string& file,
+    const std::vector<long long int>& dims) {
+  IdxFile idx(file);
+  if (idx.GetDims() != std::vector<size_t>(dims.begin(), dims.end())) {
+    throw af::exception("[mnist:load_data] Unexpected MNIST dimension.");
   }
-  return d;
+  return idx;
 }
 
-template <typename T>
-af::array load_data(const std::string& im_file,
-    const std::vector<long long int>& dims) {
-  std::ifstream file(im_file, std::ios::binary);
-  if (!file.is_open()) {
-    throw af::exception("[mnist:load_data] Can't find MNIST file.");
-  }
-  read_int(file); // unused magic
-  size_t elems = 1;
-  for (auto d : dims) {
-    size_t read_d = read_int(file);
-    elems *= read_d;
-    if (read_d != d) {
-      throw af::exception("[mnist:load_data] Unexpected MNIST dimension.");
-    }
-  }
+// Make the splits from byte images and labels. Examples are contiguous,
+// so each split is copied straight from memory.
+MnistSplits make_splits(const uint8_t* train_images,
+    const int32_t* train_labels, const uint8_t* test_images,
+    const int32_t* test_labels) {
+  MnistSplits splits;
+  splits.train_x_ = af::array(kImDim, kImDim, 1, kTrainSize, train_images);
+  splits.train_y_ = af::array(kTrainSize, train_labels);
+  splits.test_x_ = af::array(kImDim, kImDim, 1, kTestSize, test_images);
+  splits.test_y_ = af::array(kTestSize, test_labels);
+  return splits;
+}
 
-  std::vector<T> data;
-  data.reserve(elems);
-  for (size_t i = 0; i < elems; i++) {
-    unsigned char tmp;
-    file.read((char*)&tmp, sizeof(tmp));
-    data.push_back(tmp);
-  }
+MnistSplits load_splits(const std::string& data_dir) {
+  IdxFile train_images = open_data(data_dir + "/train-images-idx3-ubyte",
+                                   {kTrainSize, kImDim, kImDim});
+  IdxFile train_labels = open_data(data_dir + "/train-labels-idx1-ubyte",
+                                   {kTrainSize});
+  IdxFile test_images = open_data(data_dir + "/t10k-images-idx3-ubyte",
+                                  {kTestSize, kImDim, kImDim});
+  IdxFile test_labels = open_data(data_dir + "/t10k-labels-idx1-ubyte",
+                                  {kTestSize});
+
+  // pixels are copied from the mappings as bytes, and normalized per batch
+  // by the datasets; only the labels are widened
+  std::vector<int32_t> train_y(train_labels.GetData(),
+      train_labels.GetData() + train_labels.GetElementCount());
+  std::vector<int32_t> test_y(test_labels.GetData(),
+      test_labels.GetData() + test_labels.GetElementCount());
+
+  return make_splits(train_images.GetData(), train_y.data(),
+                     test_images.GetData(), test_y.data());
+}
 
-  std::vector<long long int> rdims(dims.rbegin(), dims.rend());
-  // af is column-major
-  af::dim4 af_dims(rdims.size(), rdims.data());
-  return af::array(af_dims, data.data());
+void add_data_node(neurons::Network& network, const MnistSplits& splits,
+    dim_t batch_size, size_t prefetch_threads, size_t prefetch_depth,
+    bool augment /* = false */) {
+  // Make the datasets, which keep the pixels as bytes until batched and
+  // prepare the next batches in the background
+  auto prefetch = [=](std::shared_ptr<fl::Dataset> batches) {
+    return std::make_unique<PrefetchDataset>(std::move(batches),
+        prefetch_threads, prefetch_depth);
+  };
+
+  // validation and train sets are views of the same examples, so the split
+  // can be moved later through DataNode::SetValidationSplit
+  auto train_batches = std::make_shared<ByteImageDataset>(
+      splits.train_x_, splits.train_y_, batch_size, kPixelOffset,
+      kPixelScale);
+  auto valid_batches = std::make_shared<ByteImageDataset>(
+      *train_batches, 0, kValSize);
+  train_batches->SetRange(kValSize, kTrainSize);
+  // only the train set is worth visiting in a new order every epoch
+  train_batches->EnableShuffle(kShuffleSeed);
+
+  auto test_batches = std::make_shared<ByteImageDataset>(
+      splits.test_x_, splits.test_y_, batch_size, kPixelOffset, kPixelScale);
+
+  // augment the train set on the prefetch workers, ahead of training.
+  // the wrapper is kept when off, so DataNode::SetAugmentation can turn it on
+  auto augmented_train_batches = std::make_shared<AugmentDataset>(
+      train_batches, kMnistAugmentation, kAugmentSeed);
+  augmented_train_batches->SetEnabled(augment);
+
+  network.AddNode(prefetch(augmented_train_batches), prefetch(valid_batches),
+                  prefetch(test_batches));
 }
 
-std::pair<af::array, af::array> load_dataset(
-    const std::string& data_dir,
-    bool test /* = false */) {
-  std::string f = test ? "t10k" : "train";
-  int size = test ? kTestSize : kTrainSize;
+// Input and target records of one split
+using RecordPair = std::pair<std::shared_ptr<const RecordSource>,
+                             std::shared_ptr<const RecordSource>>;
+
+// Add a DataNode to network streaming each split from the input and target
+// records that open returns for its files.
+void add_streamed_data_node(neurons::Network& network,
+    const RecordFiles& train, const RecordFiles& valid,
+    const RecordFiles& test,
+    const std::function<RecordPair(const RecordFiles&)>& open,
+    dim_t batch_size, float offset, float scale, size_t prefetch_threads,
+    size_t prefetch_depth) {
+  // batches are read from the files as they are prefetched
+  auto stream = [&](const RecordFiles& files) {
+    auto records = open(files);
+    auto batches = std::make_shared<RecordDataset>(records.first,
+        records.second, batch_size, offset, scale);
+    return std::make_unique<PrefetchDataset>(std::move(batches),
+        prefetch_threads, prefetch_depth);
+  };
+
+  auto train_batches = stream(train);
+  auto valid_batches = stream(valid);
+  auto test_batches = stream(test);
+  network.AddNode(std::move(train_batches), std::move(valid_batches),
+                  std::move(test_batches));
+}
 
-  std::string image_file = data_dir + "/" + f + "-images-idx3-ubyte";
-  af::array ims = load_data<float>(image_file, {size, kImDim, kImDim});
-  ims = moddims(ims, {kImDim, kImDim, 1, size});
-  // Rescale to [-0.5,  0.5]
-  ims = (ims - kPixelMax / 2) / kPixelMax;
+void add_record_data_node(neurons::Network& network,
+    const RecordFiles& train, const RecordFiles& valid,
+    const RecordFiles& test, dim_t batch_size, float offset, float scale,
+    size_t prefetch_threads, size_t prefetch_depth) {
+  add_streamed_data_node(network, train, valid, test,
+      [](const RecordFiles& files) {
+        return RecordPair(OpenRecordFile(files.inputs_),
+                          OpenRecordFile(files.targets_));
+      },
+      batch_size, offset, scale, prefetch_threads, prefetch_depth);
+}
 
-  std::string label_file = data_dir + "/" + f + "-labels-idx1-ubyte";
-  af::array labels = load_data<int>(label_file, {size});
+void add_raw_record_data_node(neurons::Network& network,
+    const RecordFiles& train, const RecordFiles& valid,
+    const RecordFiles& test, const RawRecordLayout& layout,
+    dim_t batch_size, float offset, float scale, size_t prefetch_threads,
+    size_t prefetch_depth) {
+  add_streamed_data_node(network, train, valid, test,
+      [&layout](const RecordFiles& files) {
+        return RecordPair(
+            RecordFile::OpenRaw(files.inputs_, layout.input_type_,
+                                layout.input_shape_),
+            RecordFile::OpenRaw(files.targets_, layout.target_type_,
+                                layout.target_shape_));
+      },
+      batch_size, offset, scale, prefetch_threads, prefetch_depth);
+}
 
-  return std::make_pair(ims, labels);
+void add_synthetic_data_node(neurons::Network& network,
+    const af::dim4& example_dims, int class_count, dim_t train_size,
+    dim_t eval_size, dim_t batch_size, uint64_t seed) {
+  // standard deviation of the noise around the class prototypes, enough to
+  // make the classes overlap a little
+  const float noise = 0.5f;
+  auto train_batches = std::make_unique<SyntheticDataset>(example_dims,
+      class_count, train_size, batch_size, noise, seed);
+  auto valid_batches = std::make_unique<SyntheticDataset>(*train_batches,
+      eval_size, seed + 1);
+  auto test_batches = std::make_unique<SyntheticDataset>(*train_batches,
+      eval_size, seed + 2);
+  network.AddNode(std::move(train_batches), std::move(valid_batches),
+                  std::move(test_batches));
 }
 
-std::pair<double, double> eval_loop(neurons::NetworkContainer& model,
+ClassificationMetrics::Results eval_loop(neurons::NetworkContainer& model,
     fl::Dataset& dataset) {
 
-  fl::AverageValueMeter loss_meter;
-  fl::FrameErrorMeter error_meter;
+  // totals stay on the device until the whole dataset has been evaluated
+  std::unique_ptr<ClassificationMetrics> metrics;
 
   // place model into evaluation mode
   model.eval();
@@ -83,42 +190,61 @@ std::pair<double, double> eval_loop(neurons::NetworkContainer& model,
     auto target = fl::noGrad(example.at(mnist_utilities::kTargetIdx));
 
     auto output = model(inputs);
-
-    // retrieve the prediction from the output (maximum values)
-    af::array max_vals, max_ids;
-    af::max(max_vals, max_ids, output.array(), 0);
-
-    // record prediction error
-    error_meter.add(af::reorder(max_ids, 1, 0), target.array());
-
-    // record loss
-    loss_meter.add(
-        fl::categoricalCrossEntropy(output, target).array().scalar<float>());
+    if (metrics == nullptr) {
+      metrics = std::make_unique<ClassificationMetrics>(
+          static_cast<int>(output.dims(0)));
+    }
+    metrics->Add(output.array(), target.array(),
+                 fl::categoricalCrossEntropy(output, target).array());
   }
 
   // back to training mode
   model.train();
 
-  double error = error_meter.value();
-  double loss = loss_meter.value().at(0);
+  if (metrics == nullptr) {
+    return {0, 0, 0, {}, {}, {}};
+  }
+  return metrics->Read();
+}
 
-  return std::make_pair(loss, error);
+// Writes how often the consumer of the dataset waited on prefetching,
+// if the dataset prefetches, then resets the counts.
+void report_prefetch(fl::Dataset& dataset, const std::string& name,
+                     std::ostream& output) {
+  auto* prefetch = dynamic_cast<PrefetchDataset*>(&dataset);
+  if (prefetch == nullptr) {
+    return;
+  }
+  PrefetchDataset::Counters counters = prefetch->GetCounters();
+  output << name << " prefetch: " << counters.starved_ << " starved, "
+         << counters.misses_ << " missed of " << counters.requests_
+         << " batches, waited " << std::setprecision(3)
+         << counters.wait_seconds_ << "s" << std::endl;
+  prefetch->ResetCounters();
 }
 
 void train_model_inner(neurons::NetworkContainer& model, neurons::DataNode& data,
-                       fl::FirstOrderOptimizer& optimizer,
-                       int epochs, std::ostream& output, bool& training) {
+                       fl::FirstOrderOptimizer& optimizer, int epochs,
+                       int readback_interval, std::ostream& output,
+                       bool& training, const TrainCallbacks& callbacks) {
 
-  output << "MNIST dataset: loaded "
+  output << "Dataset: loaded "
          << data.train_dataset_->size() << " train batches" << std::endl
-         << "MNIST dataset: loaded "
+         << "Dataset: loaded "
          << data.valid_dataset_->size() << " validation batches" << std::endl
-         << "MNIST dataset: loaded "
+         << "Dataset: loaded "
          << data.test_dataset_->size() << " test batches" << std::endl;
 
   for (int epoch = 0; epoch < epochs; ++epoch) {
 
-    fl::AverageValueMeter train_loss_meter;
+    data.BeginEpoch(static_cast<size_t>(epoch));
+
+    // losses are summed on the device and only read back every
+    // readback_interval batches, since reading waits for the device to
+    // finish every queued step
+    af::array loss_sum = af::constant(0, 1, f32);
+    double train_loss_total = 0;
+    int batches = 0;
 
     for (auto& example : *(data.train_dataset_)) {
       // if training has been halted, immediate return.
@@ -134,46 +260,71 @@ void train_model_inner(neurons::NetworkContainer& model, neurons::DataNode& data
 
       // compute loss
       auto loss = fl::categoricalCrossEntropy(outputs, targets);
-      train_loss_meter.add(loss.array().scalar<float>());
+      loss_sum += loss.array();
+      // evaluate now, so the sum does not build up one long JIT kernel
+      loss_sum.eval();
+      ++batches;
 
       // backprop, update weights, then zero gradients
       loss.backward();
       optimizer.step();
       optimizer.zeroGrad();
+
+      if (readback_interval > 0 && batches % readback_interval == 0) {
+        train_loss_total += loss_sum.scalar<float>();
+        loss_sum = af::constant(0, 1, f32);
+        output << "Epoch " << epoch << ": " << batches << "/"
+               << data.train_dataset_->size() << " batches, Avg Train Loss: "
+               << std::setprecision(3) << train_loss_total / batches
+               << std::endl;
+      }
     }
 
-    double train_loss = train_loss_meter.value().at(0);
+    train_loss_total += loss_sum.scalar<float>();
+    double train_loss = batches > 0 ? train_loss_total / batches : 0;
 
     // evaluate on validation set
-    double val_loss, val_error;
-    std::tie(val_loss, val_error) = eval_loop(model, *data.valid_dataset_);
+    auto validation = eval_loop(model, *data.valid_dataset_);
 
     output << "Epoch " << epoch << std::setprecision(3)
            << ": Avg Train Loss: " << train_loss
-           << " Validation Loss: " << val_loss
-           << " Validation Error (%): " << val_error << std::endl;
+           << " Validation Loss: " << validation.loss_
+           << " Validation Error (%): " << validation.error_ << std::endl;
+    report_prefetch(*data.train_dataset_, "Train", output);
+    report_prefetch(*data.valid_dataset_, "Validation", output);
+    if (callbacks.on_epoch_) {
+      callbacks.on_epoch_(epoch, train_loss, validation);
+    }
   }
 
-  // report test loss and error
-  double test_loss, test_error;
-  std::tie(test_loss, test_error) = eval_loop(model, *data.test_dataset_);
-  output << "Test Loss: " << test_loss
-         << " Test Error (%): " << test_error << std::endl;
+  // report test loss and error, then how well each class was recognized
+  auto test = eval_loop(model, *data.test_dataset_);
+  output << "Test Loss: " << test.loss_
+         << " Test Error (%): " << test.error_ << std::endl;
+  for (size_t c = 0; c < test.precision_.size(); ++c) {
+    output << "Class " << c << ": Precision: " << test.precision_.at(c)
+           << " Recall: " << test.recall_.at(c) << std::endl;
+  }
+  if (callbacks.on_test_) {
+    callbacks.on_test_(test);
+  }
 }
 
 
 // Wraps train_model_inner() call with a try-catch block to return any
 // exceptions.
 void train_model(neurons::NetworkContainer& model, neurons::DataNode& data,
-                 fl::FirstOrderOptimizer& optimizer,
-                 int epochs, std::ostream& output, bool& training,
-                 std::exception_ptr& exception_ptr) {
+                 fl::FirstOrderOptimizer& optimizer, int epochs,
+                 int readback_interval, std::ostream& output, bool& training,
+                 std::exception_ptr& exception_ptr,
+                 const TrainCallbacks& callbacks) {
 
   training = true;
   output << model.prettyString(); // print network before training
 
   try {
-    train_model_inner(model, data, optimizer, epochs, output, training);
+    train_model_inner(model, data, optimizer, epochs, readback_interval,
+                      output, training, callbacks);
   } catch (std::exception& exception) {
     exception_ptr = std::current_exception();
   }
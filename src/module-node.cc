@@ -49,6 +49,8 @@ std::string NodeTypeToString(NodeType type) {
       return "MeanAbsoluteError";
     case MeanSquaredError:
       return "MeanSquaredError";
+    case Dataset:
+      return "Dataset";
     default:
       throw std::exception();
   }
@@ -2,48 +2,110 @@
 
 #include "neurons/network-container.h"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 #include "neurons/utilities.h"
 
 namespace neurons {
 
-NetworkContainer::NetworkContainer(NodeDeque& nodes,
-    const std::deque<Link>& links) : links_(links) {
+// Marks nodes that do not hold an execution plan slot (i.e. the loss node)
+const size_t kNoSlot = std::numeric_limits<size_t>::max();
 
-  // check graph requirements.
-  if (!utilities::NodesAndLinksConsistent(nodes, links)) {
-    throw std::invalid_argument("Passed nodes and links are inconsistent.");
-  }
-  if (utilities::CountConnectedComponents(nodes, links) != 1) {
-    throw std::invalid_argument("Graph does not consist of 1 component.");
-  }
-  if (utilities::ContainsDirectedCycle(nodes, links)) {
-    throw std::invalid_argument("Graph contains a directed cycle.");
-  }
-  if (!utilities::AreNodeInputsSatisfied(nodes, links)) {
-    throw std::invalid_argument("Graph node inputs are not satisfied.");
-  }
-  if (!utilities::AreNodeOutputsSatisfied(nodes, links)) {
-    throw std::invalid_argument("Graph node outputs are not satisfied.");
+NetworkContainer::NetworkContainer(const NodeDeque& nodes,
+    const std::deque<Link>& links)
+    : NetworkContainer(GraphSnapshot(nodes, links)) {}
+
+NetworkContainer::NetworkContainer(const GraphSnapshot& graph)
+    : links_(graph.GetLinks()), peak_slot_bytes_(0) {
+
+  // check graph requirements, reporting every violation at once.
+  auto violations = utilities::ValidateGraph(graph);
+  if (!violations.empty()) {
+    std::ostringstream message;
+    for (const auto& violation : violations) {
+      message << utilities::GraphViolationToString(violation) << std::endl;
+    }
+    throw std::invalid_argument(message.str());
   }
 
-  // get a topologically sorted list of nodes (guaranteed to exist now)
-  // the shared_ptrs in sorted are identical to that of nodes
-  NodeDeque sorted = utilities::TopologicalSort(nodes, links);
+  // get a topologically sorted list of node indices (guaranteed to exist now)
+  const NodeDeque& nodes = graph.GetNodes();
+  const std::vector<size_t>& sorted = graph.GetTopologicalOrder();
 
   // if previous graph conditions are satisfied, then first element
   // of sorted is a DataNode and last element is a loss node
-  // pop those off to get the elements that are ModuleNodes
-  data_node_id_ = sorted.front()->GetId();
-  sorted.pop_front();
-  loss_node_id_ = sorted.back()->GetId();
-  sorted.pop_back();
+  // the elements in between are ModuleNodes
+  const size_t data_node = sorted.front();
+  const size_t loss_node = sorted.back();
+  data_node_id_ = nodes.at(data_node)->GetId();
+  loss_node_id_ = nodes.at(loss_node)->GetId();
+
+  // execution plan slot holding the output of each node index
+  std::vector<size_t> node_slots(nodes.size(), kNoSlot);
+  node_slots.at(data_node) = kDataSlot;
 
-  for (auto& node : sorted) {
+  for (size_t i = 1; i + 1 < sorted.size(); ++i) {
     // by graph conditions, nodes should all be ModuleNodes
-    auto module_node = std::dynamic_pointer_cast<ModuleNode>(node);
+    auto module_node = std::dynamic_pointer_cast<ModuleNode>(
+        nodes.at(sorted.at(i)));
     // module_node is a shared_ptr controlled by the passed nodes argument
     // if it is nullptr (dynamic cast fails), then add will throw an exception.
     add(module_node);
+    node_slots.at(sorted.at(i)) = modules_.size();
+  }
+
+  // resolve every link into a slot read by a module or by the loss node
+  input_slots_.resize(modules_.size());
+  for (size_t link = 0; link < links_.size(); ++link) {
+    size_t input_slot = node_slots.at(graph.GetLinkInput(link));
+    if (input_slot == kNoSlot) {
+      throw std::invalid_argument("Network links are invalid.");
+    }
+
+    if (graph.GetLinkOutput(link) == loss_node) {
+      // the model output must come from a module, as a link from the
+      // DataNode would compare the inputs with the targets
+      if (input_slot == kDataSlot) {
+        throw std::invalid_argument("Loss node cannot read the DataNode.");
+      }
+      output_slots_.push_back(input_slot);
+      continue;
+    }
+
+    // modules_ is topologically sorted, so a module may only read slots
+    // that are filled before it runs
+    size_t output_slot = node_slots.at(graph.GetLinkOutput(link));
+    if (output_slot == kNoSlot || input_slot >= output_slot) {
+      throw std::invalid_argument("Network links are invalid.");
+    }
+    input_slots_.at(output_slot - 1).push_back(input_slot);
+  }
+
+  // liveness analysis: find the last module that reads each slot.
+  // slots read by the loss node must stay live until the output is formed,
+  // so they are marked with a step past the last module.
+  const size_t output_step = modules_.size();
+  std::vector<size_t> last_use(modules_.size() + 1, 0);
+  for (size_t slot = kDataSlot + 1; slot < last_use.size(); ++slot) {
+    // an unread output can be released right after its module runs
+    last_use.at(slot) = slot - 1;
+  }
+  for (size_t step = 0; step < input_slots_.size(); ++step) {
+    for (size_t slot : input_slots_.at(step)) {
+      last_use.at(slot) = std::max(last_use.at(slot), step);
+    }
+  }
+  for (size_t slot : output_slots_) {
+    last_use.at(slot) = output_step;
+  }
+
+  release_slots_.resize(modules_.size());
+  for (size_t slot = 0; slot < last_use.size(); ++slot) {
+    if (last_use.at(slot) < output_step) {
+      release_slots_.at(last_use.at(slot)).push_back(slot);
+    }
   }
 }
 
@@ -65,6 +127,28 @@ std::vector<fl::Variable> Add(const std::vector<fl::Variable>& lhs,
   return result;
 }
 
+// Sums the outputs held in the passed slots element-wise.
+// Returns an empty vector if no slots are passed.
+std::vector<fl::Variable> SumSlots(
+    const std::vector<std::vector<fl::Variable>>& outputs,
+    const std::vector<size_t>& slots) {
+  std::vector<fl::Variable> sum;
+  for (size_t slot : slots) {
+    // throws an exception if any dimensions do not match
+    sum = sum.empty() ? outputs.at(slot) : Add(sum, outputs.at(slot));
+  }
+  return sum;
+}
+
+// Returns the number of bytes held by the passed fl::Variables.
+size_t CountBytes(const std::vector<fl::Variable>& variables) {
+  size_t bytes = 0;
+  for (const auto& variable : variables) {
+    bytes += variable.bytes();
+  }
+  return bytes;
+}
+
 std::vector<fl::Variable> NetworkContainer::forward(
     const std::vector<fl::Variable>& input) {
   // network comprises of UnaryModules, so only input is allowed
@@ -72,57 +156,31 @@ std::vector<fl::Variable> NetworkContainer::forward(
     throw std::invalid_argument("Network expects only one input");
   }
 
-  // maps each node to its module output
-  // if a node has multiple inputs, sums them all into a single input
-  auto output_maps = std::map<fl::ModulePtr, std::vector<fl::Variable>>();
-
-  // modules_ is topologically sorted, so the input to each module
-  // is guaranteed to have been processed by the time they're reached
-  for (const auto& module : modules_) {
-    // create an empty module with the correct dimensions
-    std::vector<fl::Variable> module_input;
-    // find the input links to module
-    for (const auto& link : links_) {
-      // comparison method from stackoverflow.com/questions/37489209
-      if (std::dynamic_pointer_cast<void>(link.output_) !=
-          std::dynamic_pointer_cast<void>(module)) {
-        continue;
-      }
-      // if link input is data node, use the input directly, otherwise get
-      // from output map
-      std::vector<fl::Variable> link_input;
-      if (link.input_->GetId() == data_node_id_) {
-        link_input = input;
-      } else {
-        auto module_ptr = std::dynamic_pointer_cast<fl::Module>(link.input_);
-        // check must be done as maps allow nullptr insertion
-        if (module_ptr == nullptr) {
-          throw std::runtime_error("Network links are invalid.");
-        }
-        link_input = output_maps.at(module_ptr);
-      }
-
-      // throws an exception if any dimensions do not match
-      module_input = module_input.empty() ?
-          link_input : Add(module_input, link_input);
+  // output of every slot in the execution plan
+  // if a module has multiple inputs, sums them all into a single input
+  std::vector<std::vector<fl::Variable>> outputs(modules_.size() + 1);
+  outputs.at(kDataSlot) = input;
+  size_t slot_bytes = CountBytes(input);
+  peak_slot_bytes_ = slot_bytes;
+
+  // modules_ is topologically sorted, so the input slots of each module
+  // are guaranteed to have been filled by the time they're reached
+  for (size_t i = 0; i < modules_.size(); ++i) {
+    outputs.at(i + 1) =
+        modules_.at(i)->forward(SumSlots(outputs, input_slots_.at(i)));
+    slot_bytes += CountBytes(outputs.at(i + 1));
+    peak_slot_bytes_ = std::max(peak_slot_bytes_, slot_bytes);
+
+    // drop outputs that no later module reads. when gradients are being
+    // recorded, the autograd graph keeps its own references until backward.
+    for (size_t slot : release_slots_.at(i)) {
+      slot_bytes -= CountBytes(outputs.at(slot));
+      outputs.at(slot).clear();
     }
-    auto module_output = module->forward(module_input);
-    output_maps.insert({module, module_output});
   }
 
-  // links to the loss node represent the final model output
-  std::vector<fl::Variable> output;
-  for (const auto& link : links_) {
-    if (link.output_->GetId() == loss_node_id_) {
-      auto module_ptr = std::dynamic_pointer_cast<fl::Module>(link.input_);
-      if (module_ptr == nullptr) {
-        throw std::runtime_error("Network container modules are invalid.");
-      }
-      auto link_output = output_maps.at(module_ptr);
-      // will throw an exception if dimensions are a mismatch
-      output = output.empty() ? link_output : Add(output, link_output);
-    }
-  }
+  // slots linked to the loss node represent the final model output
+  std::vector<fl::Variable> output = SumSlots(outputs, output_slots_);
 
   if (input.size() != output.size()) {
     throw std::runtime_error("Unexpected container output size.");
@@ -140,6 +198,10 @@ fl::Variable NetworkContainer::operator()(const fl::Variable& input) {
   return forward(input);
 }
 
+size_t NetworkContainer::GetPeakSlotBytes() const {
+  return peak_slot_bytes_;
+}
+
 std::string NetworkContainer::prettyString() const {
   std::ostringstream output;
   output << "Network:" << std::endl;
@@ -0,0 +1,381 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/network-spec.h>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace neurons {
+
+namespace {
+
+// Throws std::invalid_argument unless there are count arguments.
+void RequireArgs(const std::vector<double>& args, size_t count,
+                 const std::string& what) {
+  if (args.size() != count) {
+    throw std::invalid_argument(what + " takes " + std::to_string(count) +
+                                " arguments, got " +
+                                std::to_string(args.size()) + ".");
+  }
+}
+
+// Get the argument at index as an int. Throws std::invalid_argument if it
+// is not a whole number.
+int IntArg(const std::vector<double>& args, size_t index) {
+  double arg = args.at(index);
+  if (std::abs(arg) > 1e9 ||
+      std::fpclassify(std::trunc(arg) - arg) != FP_ZERO) {
+    throw std::invalid_argument("Argument " + std::to_string(index + 1) +
+                                " must be a whole number.");
+  }
+  return static_cast<int>(arg);
+}
+
+// Get the argument at index as a bool: 0 is false, anything else true.
+bool BoolArg(const std::vector<double>& args, size_t index) {
+  return std::fpclassify(args.at(index)) != FP_ZERO;
+}
+
+// Returns the NodeType named name, or Dummy if there is none.
+NodeType ParseNodeType(const std::string& name) {
+  for (int type = Dummy; type <= Dataset; ++type) {
+    if (NodeTypeToString(static_cast<NodeType>(type)) == name) {
+      return static_cast<NodeType>(type);
+    }
+  }
+  return Dummy;
+}
+
+// Reads the remaining words of a statement as numbers.
+std::vector<double> ParseArgs(std::istringstream& words) {
+  std::vector<double> args;
+  std::string word;
+  while (words >> word) {
+    size_t parsed = 0;
+    double arg = std::stod(word, &parsed);
+    if (parsed != word.size()) {
+      throw std::invalid_argument("Argument " + word + " is not a number.");
+    }
+    args.push_back(arg);
+  }
+  return args;
+}
+
+}  // namespace
+
+NetworkSpec ParseNetworkSpec(std::istream& input) {
+  NetworkSpec spec;
+  bool has_optimizer = false;
+  std::unordered_map<std::string, bool> names = {{kDataNodeName, true}};
+
+  std::string line;
+  for (size_t number = 1; std::getline(input, line); ++number) {
+    std::istringstream words(line.substr(0, line.find('#')));
+    std::string statement;
+    if (!(words >> statement)) {
+      continue;
+    }
+    try {
+      if (statement == "node") {
+        NetworkSpec::NodeSpec node;
+        std::string type;
+        if (!(words >> node.name_ >> type)) {
+          throw std::invalid_argument("Expected node <name> <NodeType>.");
+        }
+        node.type_ = ParseNodeType(type);
+        if (node.type_ == Dummy || node.type_ == Dataset) {
+          throw std::invalid_argument("Unknown node type " + type + ".");
+        }
+        if (!names.emplace(node.name_, true).second) {
+          throw std::invalid_argument("Node " + node.name_ +
+                                      " is already declared.");
+        }
+        node.args_ = ParseArgs(words);
+        spec.nodes_.push_back(std::move(node));
+      } else if (statement == "link") {
+        std::string input_name, output_name, extra;
+        if (!(words >> input_name >> output_name) || words >> extra) {
+          throw std::invalid_argument("Expected link <input> <output>.");
+        }
+        spec.links_.emplace_back(input_name, output_name);
+      } else if (statement == "optimizer") {
+        if (has_optimizer) {
+          throw std::invalid_argument("Optimizer is already declared.");
+        }
+        if (!(words >> spec.optimizer_.name_)) {
+          throw std::invalid_argument("Expected optimizer <name>.");
+        }
+        spec.optimizer_.args_ = ParseArgs(words);
+        has_optimizer = true;
+      } else {
+        throw std::invalid_argument("Unknown statement " + statement + ".");
+      }
+    } catch (const std::logic_error& error) {
+      // std::stod throws std::invalid_argument and std::out_of_range
+      throw std::invalid_argument("Line " + std::to_string(number) + ": " +
+                                  error.what());
+    }
+  }
+
+  if (!has_optimizer) {
+    throw std::invalid_argument("Network spec has no optimizer.");
+  }
+  return spec;
+}
+
+NetworkSpec LoadNetworkSpec(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Can't read network spec " + path);
+  }
+  return ParseNetworkSpec(file);
+}
+
+std::unique_ptr<fl::Module> MakeModule(NodeType type,
+    const std::vector<double>& args) {
+  const std::string name = NodeTypeToString(type);
+  switch (type) {
+    case Sigmoid:
+    case Tanh:
+    case HardTanh:
+    case ReLU:
+    case LeakyReLU:
+    case ELU:
+    case ThresholdReLU:
+    case GatedLinearUnit:
+    case LogSoftmax:
+    case Log:
+    case CategoricalCrossEntropy:
+    case MeanAbsoluteError:
+    case MeanSquaredError:
+      RequireArgs(args, 0, name);
+      break;
+    default:
+      break;
+  }
+
+  switch (type) {
+    case Sigmoid:
+      return std::make_unique<fl::Sigmoid>();
+    case Tanh:
+      return std::make_unique<fl::Tanh>();
+    case HardTanh:
+      return std::make_unique<fl::HardTanh>();
+    case ReLU:
+      return std::make_unique<fl::ReLU>();
+    case LeakyReLU:
+      return std::make_unique<fl::LeakyReLU>();
+    case ELU:
+      return std::make_unique<fl::ELU>();
+    case ThresholdReLU:
+      return std::make_unique<fl::ThresholdReLU>();
+    case GatedLinearUnit:
+      return std::make_unique<fl::GatedLinearUnit>();
+    case LogSoftmax:
+      return std::make_unique<fl::LogSoftmax>();
+    case Log:
+      return std::make_unique<fl::Log>();
+    case CategoricalCrossEntropy:
+      return std::make_unique<fl::CategoricalCrossEntropy>();
+    case MeanAbsoluteError:
+      return std::make_unique<fl::MeanAbsoluteError>();
+    case MeanSquaredError:
+      return std::make_unique<fl::MeanSquaredError>();
+
+    case BatchNorm: {
+      // feature axis, feature size, momentum, epsilon, affine, track stats
+      RequireArgs(args, 6, name);
+      if (IntArg(args, 0) < 0 || IntArg(args, 1) <= 0) {
+        throw std::invalid_argument("BatchNorm axis or size out of range.");
+      }
+      return std::make_unique<fl::BatchNorm>(IntArg(args, 0), IntArg(args, 1),
+          args.at(2), args.at(3), BoolArg(args, 4), BoolArg(args, 5));
+    }
+    case LayerNorm: {
+      // normalization axis, epsilon, affine
+      RequireArgs(args, 3, name);
+      if (IntArg(args, 0) < 0) {
+        throw std::invalid_argument("LayerNorm axis out of range.");
+      }
+      return std::make_unique<fl::LayerNorm>(IntArg(args, 0), args.at(1),
+          BoolArg(args, 2), fl::kLnVariableAxisSize);
+    }
+    case Dropout: {
+      // dropout ratio
+      RequireArgs(args, 1, name);
+      if (!(args.at(0) >= 0 && args.at(0) < 1)) {
+        throw std::invalid_argument("Dropout ratio must be in [0, 1).");
+      }
+      return std::make_unique<fl::Dropout>(args.at(0));
+    }
+    case View: {
+      // four dims, at most one of which is -1
+      RequireArgs(args, 4, name);
+      int inferred = 0;
+      for (size_t i = 0; i < 4; ++i) {
+        if (IntArg(args, i) < -1) {
+          throw std::invalid_argument("View dims must be -1 or more.");
+        }
+        inferred += IntArg(args, i) == -1 ? 1 : 0;
+      }
+      if (inferred > 1) {
+        throw std::invalid_argument("View can only infer one dim.");
+      }
+      return std::make_unique<fl::View>(af::dim4(IntArg(args, 0),
+          IntArg(args, 1), IntArg(args, 2), IntArg(args, 3)));
+    }
+    case Conv2D: {
+      // input and output channels, kernel size, stride, padding and
+      // dilation along x and y, then learnable bias
+      RequireArgs(args, 11, name);
+      for (size_t i = 0; i < 10; ++i) {
+        bool padding = i == 6 || i == 7;
+        if (!(IntArg(args, i) > 0 || (padding && IntArg(args, i) >= -1))) {
+          throw std::invalid_argument("Conv2D argument " +
+                                      std::to_string(i + 1) +
+                                      " out of range.");
+        }
+      }
+      return std::make_unique<fl::Conv2D>(IntArg(args, 0), IntArg(args, 1),
+          IntArg(args, 2), IntArg(args, 3), IntArg(args, 4), IntArg(args, 5),
+          IntArg(args, 6), IntArg(args, 7), IntArg(args, 8), IntArg(args, 9),
+          BoolArg(args, 10));
+    }
+    case Pool2D: {
+      // window, stride and padding along x and y, then the pooling mode:
+      // 0 for MAX, 1 for AVG_INCLUDE_PADDING, 2 for AVG_EXCLUDE_PADDING
+      RequireArgs(args, 7, name);
+      for (size_t i = 0; i < 6; ++i) {
+        if (!(IntArg(args, i) > 0 || (i >= 4 && IntArg(args, i) >= -1))) {
+          throw std::invalid_argument("Pool2D argument " +
+                                      std::to_string(i + 1) +
+                                      " out of range.");
+        }
+      }
+      const fl::PoolingMode modes[] = {fl::PoolingMode::MAX,
+                                       fl::PoolingMode::AVG_INCLUDE_PADDING,
+                                       fl::PoolingMode::AVG_EXCLUDE_PADDING};
+      int mode = IntArg(args, 6);
+      if (mode < 0 || mode > 2) {
+        throw std::invalid_argument("Pool2D mode must be 0, 1 or 2.");
+      }
+      return std::make_unique<fl::Pool2D>(IntArg(args, 0), IntArg(args, 1),
+          IntArg(args, 2), IntArg(args, 3), IntArg(args, 4), IntArg(args, 5),
+          modes[mode]);
+    }
+    case Linear: {
+      // input size, output size, learnable bias
+      RequireArgs(args, 3, name);
+      if (IntArg(args, 0) <= 0 || IntArg(args, 1) <= 0) {
+        throw std::invalid_argument("Linear sizes must be positive.");
+      }
+      return std::make_unique<fl::Linear>(IntArg(args, 0), IntArg(args, 1),
+          BoolArg(args, 2));
+    }
+    default:
+      throw std::invalid_argument(name + " nodes have no module.");
+  }
+}
+
+void BuildNetwork(const NetworkSpec& spec, Network& network) {
+  std::unordered_map<std::string, std::shared_ptr<Node>> nodes = {
+      {kDataNodeName, network.GetDataNode()}};
+  if (nodes.at(kDataNodeName) == nullptr) {
+    throw std::invalid_argument("Network has no DataNode.");
+  }
+
+  for (const auto& node : spec.nodes_) {
+    std::shared_ptr<Node> added;
+    try {
+      added = network.AddNode(node.type_, MakeModule(node.type_, node.args_));
+    } catch (const std::invalid_argument& error) {
+      throw std::invalid_argument("Node " + node.name_ + ": " + error.what());
+    }
+    if (added == nullptr) {
+      throw std::invalid_argument("Node " + node.name_ + " was not added.");
+    }
+    nodes[node.name_] = added;
+  }
+
+  for (const auto& link : spec.links_) {
+    auto input = nodes.find(link.first);
+    auto output = nodes.find(link.second);
+    if (input == nodes.end() || output == nodes.end()) {
+      throw std::invalid_argument("Link " + link.first + " -> " +
+                                  link.second + " names an unknown node.");
+    }
+    LinkRejection rejection;
+    if (network.AddLink(input->second, output->second, rejection) ==
+        nullptr) {
+      throw std::invalid_argument("Link " + link.first + " -> " +
+                                  link.second + ": " +
+                                  LinkRejectionToString(rejection));
+    }
+  }
+}
+
+std::shared_ptr<fl::FirstOrderOptimizer> MakeOptimizer(
+    const NetworkSpec::OptimizerSpec& spec,
+    const std::vector<fl::Variable>& params) {
+  const std::string& name = spec.name_;
+  const std::vector<double>& args = spec.args_;
+  auto arg = [&args](size_t index) {
+    return static_cast<float>(args.at(index));
+  };
+
+  if (name == "AdadeltaOptimizer" || name == "RMSPropOptimizer") {
+    // learning rate, rho, epsilon, weight decay
+    RequireArgs(args, 4, name);
+    if (!(arg(0) > 0 && arg(1) > 0 && arg(2) > 0 && arg(3) >= 0)) {
+      throw std::invalid_argument(name + " arguments out of range.");
+    }
+    if (name == "AdadeltaOptimizer") {
+      return std::make_shared<fl::AdadeltaOptimizer>(params, arg(0), arg(1),
+                                                     arg(2), arg(3));
+    }
+    return std::make_shared<fl::RMSPropOptimizer>(params, arg(0), arg(1),
+                                                  arg(2), arg(3));
+  }
+  if (name == "AdagradOptimizer") {
+    // learning rate, epsilon, weight decay
+    RequireArgs(args, 3, name);
+    if (!(arg(0) > 0 && arg(1) > 0 && arg(2) >= 0)) {
+      throw std::invalid_argument(name + " arguments out of range.");
+    }
+    return std::make_shared<fl::AdagradOptimizer>(params, arg(0), arg(1),
+                                                  arg(2));
+  }
+  if (name == "AdamOptimizer" || name == "AMSgradOptimizer" ||
+      name == "NovogradOptimizer") {
+    // learning rate, beta1, beta2, epsilon, weight decay
+    RequireArgs(args, 5, name);
+    if (!(arg(0) > 0 && arg(1) > 0 && arg(2) > 0 && arg(3) > 0 &&
+          arg(4) >= 0)) {
+      throw std::invalid_argument(name + " arguments out of range.");
+    }
+    if (name == "AdamOptimizer") {
+      return std::make_shared<fl::AdamOptimizer>(params, arg(0), arg(1),
+                                                 arg(2), arg(3), arg(4));
+    } else if (name == "AMSgradOptimizer") {
+      return std::make_shared<fl::AMSgradOptimizer>(params, arg(0), arg(1),
+                                                    arg(2), arg(3), arg(4));
+    }
+    return std::make_shared<fl::NovogradOptimizer>(params, arg(0), arg(1),
+                                                   arg(2), arg(3), arg(4));
+  }
+  if (name == "SGDOptimizer") {
+    // learning rate, momentum, weight decay, use nesterov
+    RequireArgs(args, 4, name);
+    if (!(arg(0) > 0 && arg(1) >= 0 && arg(2) >= 0)) {
+      throw std::invalid_argument(name + " arguments out of range.");
+    }
+    return std::make_shared<fl::SGDOptimizer>(params, arg(0), arg(1), arg(2),
+                                              BoolArg(args, 3));
+  }
+  throw std::invalid_argument("Unknown optimizer " + name + ".");
+}
+
+}  // namespace neurons
@@ -2,37 +2,214 @@
 
 #include "neurons/network.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 namespace neurons {
 
-// Helper function, returns whether the deque contains the Node
-bool ContainsNode(const NodeDeque& nodes,
-                  const std::shared_ptr<Node>& node) {
-  for (const auto& it : nodes) {
-    if(it == node) {
-      return true;
-    }
+std::string LinkRejectionToString(LinkRejection rejection) {
+  switch (rejection) {
+    case LinkAccepted:
+      return "Link accepted.";
+    case LinkNodeMissing:
+      return "Link rejected: node is not in the network.";
+    case LinkCreatesCycle:
+      return "Link rejected: link would create a directed cycle.";
   }
-  return false;
+  return "";
 }
 
 Link* Network::AddLink(const std::shared_ptr<Node>& input,
     const std::shared_ptr<Node>& output) {
+  LinkRejection rejection;
+  return AddLink(input, output, rejection);
+}
+
+Link* Network::AddLink(const std::shared_ptr<Node>& input,
+    const std::shared_ptr<Node>& output, LinkRejection& rejection) {
 
   // if Network does not have the Nodes, it cannot link them.
-  if (!ContainsNode(nodes_, input) || !ContainsNode(nodes_, output)) {
+  if (!ContainsNode(input) || !ContainsNode(output)) {
+    rejection = LinkNodeMissing;
     return nullptr;
   }
 
-  links_.emplace_back(unique_id_++, input, output);
-  return &links_.back();
+  Handle input_handle = node_handles_.at(input->GetId());
+  Handle output_handle = node_handles_.at(output->GetId());
+  if (!OrderLink(input_handle, output_handle)) {
+    rejection = LinkCreatesCycle;
+    return nullptr;
+  }
+
+  size_t id = unique_id_++;
+  NodeRecord* input_record = nodes_.Get(input_handle);
+  NodeRecord* output_record = nodes_.Get(output_handle);
+  input_record->successors_.insert({id, output_handle});
+  output_record->predecessors_.insert({id, input_handle});
+  if (!components_stale_) {
+    MergeComponents(nodes_.GetPosition(input_handle),
+                    nodes_.GetPosition(output_handle));
+  }
+
+  Handle handle = links_.Insert(Link(id, input, output));
+  link_handles_.insert({id, handle});
+  MarkModified();
+  rejection = LinkAccepted;
+  return links_.Get(handle);
+}
+
+// Pearce-Kelly dynamic topological sort, see:
+// D. J. Pearce and P. H. J. Kelly. A Dynamic Topological Sort Algorithm for
+// Directed Acyclic Graphs. ACM Journal of Experimental Algorithmics, 2006.
+bool Network::OrderLink(const Handle& input, const Handle& output) {
+  const size_t upper = nodes_.Get(input)->order_;
+  const size_t lower = nodes_.Get(output)->order_;
+
+  // already ordered. a node linking to itself is not considered a cycle.
+  if (lower >= upper) {
+    return true;
+  }
+
+  // find nodes reachable from output that are ordered before input
+  // if input is reachable, the link would close a cycle
+  // nodes are identified by slot index, which is unique among live nodes
+  std::vector<Handle> forward;
+  std::unordered_set<size_t> visited = {output.index_};
+  std::vector<Handle> stack = {output};
+  while (!stack.empty()) {
+    Handle node = stack.back();
+    stack.pop_back();
+    forward.push_back(node);
+    for (const auto& successor : nodes_.Get(node)->successors_) {
+      size_t order = nodes_.Get(successor.second)->order_;
+      if (order == upper) {
+        return false;
+      }
+      if (order < upper && visited.insert(successor.second.index_).second) {
+        stack.push_back(successor.second);
+      }
+    }
+  }
+
+  // find nodes that reach input that are ordered after output
+  std::vector<Handle> backward;
+  visited = {input.index_};
+  stack = {input};
+  while (!stack.empty()) {
+    Handle node = stack.back();
+    stack.pop_back();
+    backward.push_back(node);
+    for (const auto& predecessor : nodes_.Get(node)->predecessors_) {
+      if (nodes_.Get(predecessor.second)->order_ > lower &&
+          visited.insert(predecessor.second.index_).second) {
+        stack.push_back(predecessor.second);
+      }
+    }
+  }
+
+  // reassign the positions of both regions, placing the nodes reaching input
+  // before the nodes reachable from output and keeping relative order
+  auto by_order = [this](const Handle& lhs, const Handle& rhs) {
+    return nodes_.Get(lhs)->order_ < nodes_.Get(rhs)->order_;
+  };
+  std::sort(backward.begin(), backward.end(), by_order);
+  std::sort(forward.begin(), forward.end(), by_order);
+  backward.insert(backward.end(), forward.begin(), forward.end());
+
+  std::vector<size_t> positions;
+  positions.reserve(backward.size());
+  for (const Handle& node : backward) {
+    positions.push_back(nodes_.Get(node)->order_);
+  }
+  std::sort(positions.begin(), positions.end());
+  for (size_t i = 0; i < backward.size(); ++i) {
+    nodes_.Get(backward.at(i))->order_ = positions.at(i);
+  }
+  return true;
+}
+
+Handle Network::AddRecord(const std::shared_ptr<Node>& node) {
+  // IDs only increase, so new nodes are ordered after every existing node
+  Handle handle = nodes_.Insert({node, node->GetId(), {}, {}});
+  node_handles_.insert({node->GetId(), handle});
+  if (!components_stale_) {
+    // new values are placed at the back of nodes_
+    components_.push_back({components_.size(), 1});
+    ++component_count_;
+  }
+  MarkModified();
+  return handle;
+}
+
+void Network::MarkModified() {
+  node_view_stale_ = true;
+  link_view_stale_ = true;
+  snapshot_ = nullptr;
+}
+
+size_t Network::FindComponent(size_t position) const {
+  while (components_.at(position).parent_ != position) {
+    size_t& parent = components_.at(position).parent_;
+    parent = components_.at(parent).parent_;
+    position = parent;
+  }
+  return position;
+}
+
+void Network::MergeComponents(size_t lhs, size_t rhs) const {
+  lhs = FindComponent(lhs);
+  rhs = FindComponent(rhs);
+  if (lhs == rhs) {
+    return;
+  }
+  // attach the smaller tree under the larger one to keep trees shallow
+  if (components_.at(lhs).size_ < components_.at(rhs).size_) {
+    std::swap(lhs, rhs);
+  }
+  components_.at(rhs).parent_ = lhs;
+  components_.at(lhs).size_ += components_.at(rhs).size_;
+  --component_count_;
+}
+
+void Network::RefreshComponents() const {
+  if (!components_stale_) {
+    return;
+  }
+  const auto& records = nodes_.GetValues();
+  components_.resize(records.size());
+  for (size_t position = 0; position < records.size(); ++position) {
+    components_.at(position) = {position, 1};
+  }
+  component_count_ = records.size();
+  for (size_t position = 0; position < records.size(); ++position) {
+    for (const auto& successor : records.at(position).successors_) {
+      MergeComponents(position, nodes_.GetPosition(successor.second));
+    }
+  }
+  components_stale_ = false;
+}
+
+size_t Network::CountComponents() const {
+  RefreshComponents();
+  return component_count_;
+}
+
+size_t Network::GetComponentId(size_t node_id) const {
+  RefreshComponents();
+  size_t root = FindComponent(nodes_.GetPosition(node_handles_.at(node_id)));
+  return nodes_.GetValues().at(root).node_->GetId();
 }
 
 std::shared_ptr<Node> Network::AddNode(neurons::NodeType type,
     std::unique_ptr<fl::Module> module) {
   // new Node takes ownership of the module_ptr
-  nodes_.push_back(std::make_unique<neurons::ModuleNode>(
-      neurons::ModuleNode(unique_id_++, type, std::move(module))));
-  return nodes_.back();
+  std::shared_ptr<Node> node = std::make_shared<neurons::ModuleNode>(
+      neurons::ModuleNode(unique_id_++, type, std::move(module)));
+  AddRecord(node);
+  if (loss_node_ == nullptr && utilities::IsLossType(type)) {
+    loss_node_ = node;
+  }
+  return node;
 }
 
 std::shared_ptr<Node> Network::AddNode(
@@ -40,77 +217,194 @@ std::shared_ptr<Node> Network::AddNode(
     std::unique_ptr<fl::Dataset> valid_set,
     std::unique_ptr<fl::Dataset> test_set) {
   // if Dataset node already exists, just return the pointer to that
-  for (auto& node : nodes_) {
-    if (node->GetNodeType() == Dataset) {
-      return node;
-    }
+  if (data_node_ != nullptr) {
+    return data_node_;
   }
-  nodes_.push_back(std::make_unique<neurons::DataNode>(unique_id_++,
-      std::move(train_set), std::move(valid_set), std::move(test_set)));
-  return nodes_.back();
+  data_node_ = std::make_shared<neurons::DataNode>(unique_id_++,
+      std::move(train_set), std::move(valid_set), std::move(test_set));
+  AddRecord(data_node_);
+  return data_node_;
 }
 
 void Network::DeleteLink(const neurons::Link& link) {
-  // assumes that only one copy of the link exists
-  for (auto it = links_.begin(); it != links_.end(); ++it) {
-    // check if address of Link value of iterator matches
-    if (&(*it) == &link) {
-      links_.erase(it);
-      return;
+  auto handle = link_handles_.find(link.GetId());
+  if (handle == link_handles_.end()) {
+    return;
+  }
+  // only delete the link if it connects the same nodes
+  const Link* current = links_.Get(handle->second);
+  if (current->input_ == link.input_ && current->output_ == link.output_) {
+    RemoveLinks({link.GetId()});
+  }
+}
+
+void Network::DeleteLinks(const std::vector<size_t>& link_ids) {
+  std::unordered_set<size_t> deleted;
+  for (size_t id : link_ids) {
+    if (link_handles_.find(id) != link_handles_.end()) {
+      deleted.insert(id);
     }
   }
+  RemoveLinks(deleted);
 }
 
 void Network::DeleteNode(const neurons::Node& node) {
+  // assumes that only one copy of the Node exists
+  auto handle = node_handles_.find(node.GetId());
+  if (handle != node_handles_.end() &&
+      nodes_.Get(handle->second)->node_.get() == &node) {
+    DeleteNodes({node.GetId()});
+  }
+}
 
-  // remove the node first
-  for (auto it = nodes_.begin(); it != nodes_.end(); ++it) {
-    // assumes that only one copy of the Node exists
-    if ((*it).get() == &node) {
-      nodes_.erase(it);
-      break;
+void Network::DeleteNodes(const std::vector<size_t>& node_ids) {
+  std::unordered_set<size_t> deleted;
+  std::unordered_set<size_t> links;
+  for (size_t id : node_ids) {
+    auto handle = node_handles_.find(id);
+    if (handle != node_handles_.end() && deleted.insert(id).second) {
+      // only the node's own links need to be visited
+      const NodeRecord* record = nodes_.Get(handle->second);
+      for (const auto& successor : record->successors_) {
+        links.insert(successor.first);
+      }
+      for (const auto& predecessor : record->predecessors_) {
+        links.insert(predecessor.first);
+      }
     }
   }
+  if (deleted.empty()) {
+    return;
+  }
+  RemoveLinks(links);
+
+  // removing nodes and their links keeps the remaining order valid
+  for (size_t id : deleted) {
+    nodes_.Erase(node_handles_.at(id));
+    node_handles_.erase(id);
+  }
 
-  // remove any links with the node
-  for (auto it = links_.begin(); it != links_.end(); ++it) {
-    // check if link has node as input or output based on addresses
-    if (it->input_.get() == &node || it->output_.get() == &node) {
-      // removes the element and adjusts the iterator at the same time
-      it = links_.erase(it);
-      --it;
+  if (data_node_ != nullptr &&
+      deleted.find(data_node_->GetId()) != deleted.end()) {
+    data_node_ = nullptr;
+  }
+  if (loss_node_ != nullptr &&
+      deleted.find(loss_node_->GetId()) != deleted.end()) {
+    // fall back to the first remaining loss node
+    loss_node_ = nullptr;
+    for (const auto& record : nodes_.GetValues()) {
+      if (utilities::IsLossType(record.node_->GetNodeType()) &&
+          (loss_node_ == nullptr ||
+           record.node_->GetId() < loss_node_->GetId())) {
+        loss_node_ = record.node_;
+      }
     }
   }
 
+  MarkModified();
+  components_stale_ = true;
+}
+
+void Network::RemoveLinks(const std::unordered_set<size_t>& link_ids) {
+  if (link_ids.empty()) {
+    return;
+  }
+  for (size_t id : link_ids) {
+    Handle handle = link_handles_.at(id);
+    const Link* link = links_.Get(handle);
+    Handle input = node_handles_.at(link->input_->GetId());
+    Handle output = node_handles_.at(link->output_->GetId());
+    nodes_.Get(input)->successors_.erase(id);
+    nodes_.Get(output)->predecessors_.erase(id);
+
+    links_.Erase(handle);
+    link_handles_.erase(id);
+  }
+
+  MarkModified();
+  components_stale_ = true;
 }
 
-std::deque<Link>& Network::GetLinks() {
-  return links_;
+bool Network::ContainsNode(const std::shared_ptr<Node>& node) const {
+  if (node == nullptr) {
+    return false;
+  }
+  auto handle = node_handles_.find(node->GetId());
+  return handle != node_handles_.end() &&
+         nodes_.Get(handle->second)->node_ == node;
 }
 
-NodeDeque& Network::GetNodes() {
-  return nodes_;
+std::shared_ptr<Node> Network::GetNode(size_t node_id) const {
+  auto handle = node_handles_.find(node_id);
+  return handle == node_handles_.end() ? nullptr
+                                       : nodes_.Get(handle->second)->node_;
 }
 
-std::shared_ptr<DataNode> Network::GetDataNode() const {
-  for (const auto& node : nodes_) {
-    NodeType type = node->GetNodeType();
-    if (type == Dataset) {
-      return std::dynamic_pointer_cast<DataNode>(node);
+Handle Network::GetLinkHandle(size_t link_id) const {
+  return link_handles_.at(link_id);
+}
+
+const Link* Network::GetLink(const Handle& handle) const {
+  return links_.Get(handle);
+}
+
+const std::deque<Link>& Network::GetLinks() const {
+  if (link_view_stale_) {
+    // IDs only increase, so sorting by ID gives the order links were added
+    link_view_.assign(links_.GetValues().begin(), links_.GetValues().end());
+    std::sort(link_view_.begin(), link_view_.end(),
+        [](const Link& lhs, const Link& rhs) {
+          return lhs.GetId() < rhs.GetId();
+        });
+    link_view_stale_ = false;
+  }
+  return link_view_;
+}
+
+const NodeDeque& Network::GetNodes() const {
+  if (node_view_stale_) {
+    // IDs only increase, so sorting by ID gives the order nodes were added
+    node_view_.clear();
+    for (const auto& record : nodes_.GetValues()) {
+      node_view_.push_back(record.node_);
     }
+    std::sort(node_view_.begin(), node_view_.end(),
+        [](const std::shared_ptr<Node>& lhs, const std::shared_ptr<Node>& rhs) {
+          return lhs->GetId() < rhs->GetId();
+        });
+    node_view_stale_ = false;
   }
-  return nullptr;
+  return node_view_;
 }
 
-std::shared_ptr<Node> Network::GetLossNode() const {
-  for (const auto& node : nodes_) {
-    NodeType type = node->GetNodeType();
-    if (type == CategoricalCrossEntropy || type == MeanAbsoluteError ||
-        type == MeanSquaredError) {
-      return node;
+std::shared_ptr<const GraphSnapshot> Network::GetSnapshot() const {
+  if (snapshot_ == nullptr) {
+    const NodeDeque& nodes = GetNodes();
+
+    // links are only added when they keep the order valid,
+    // so the network is known to have no directed cycle
+    std::vector<size_t> orders(nodes.size());
+    std::vector<size_t> order(nodes.size());
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      orders.at(node) =
+          nodes_.Get(node_handles_.at(nodes.at(node)->GetId()))->order_;
+      order.at(node) = node;
     }
+    std::sort(order.begin(), order.end(), [&orders](size_t lhs, size_t rhs) {
+      return orders.at(lhs) < orders.at(rhs);
+    });
+    snapshot_ = std::make_shared<const GraphSnapshot>(nodes, GetLinks(),
+                                                      std::move(order));
   }
-  return nullptr;
+  return snapshot_;
+}
+
+std::shared_ptr<DataNode> Network::GetDataNode() const {
+  return data_node_;
+}
+
+std::shared_ptr<Node> Network::GetLossNode() const {
+  return loss_node_;
 }
 
-}  // namespace neurons
\ No newline at end of file
+}  // namespace neurons
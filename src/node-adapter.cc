@@ -12,10 +12,10 @@ NodeAdapter::NodeAdapter(const std::shared_ptr<Node>& node) {
   output_id_ = kIdMultiplier * node->GetId() + 2;
 }
 
-std::vector<NodeAdapter> BuildNodeAdapters(NodeDeque& nodes) {
+std::vector<NodeAdapter> BuildNodeAdapters(const NodeDeque& nodes) {
   auto adapters = std::vector<NodeAdapter>();
   adapters.reserve(nodes.size());
-  for (auto& node : nodes) {
+  for (const auto& node : nodes) {
     adapters.emplace_back(node);
   }
   return adapters;
@@ -0,0 +1,159 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/prefetch-dataset.h>
+
+#include <chrono>
+#include <stdexcept>
+
+namespace neurons {
+
+PrefetchDataset::PrefetchDataset(std::shared_ptr<fl::Dataset> dataset,
+    size_t thread_count, size_t queue_depth)
+    : WrapperDataset(std::move(dataset)), queue_depth_(queue_depth),
+      running_(0), counters_({0, 0, 0, 0.0}), stopped_(false) {
+  if (queue_depth_ == 0) {
+    return;
+  }
+  // ArrayFire devices are selected per thread
+  int device = af::getDevice();
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(&PrefetchDataset::Work, this, device);
+  }
+}
+
+PrefetchDataset::~PrefetchDataset() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    tasks_.clear();
+  }
+  task_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::vector<af::array> PrefetchDataset::get(int64_t idx) const {
+  if (idx < 0 || idx >= size()) {
+    throw std::out_of_range("Dataset index out of range.");
+  }
+  if (workers_.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counters_.requests_;
+    return dataset_->get(idx);
+  }
+
+  std::future<std::vector<af::array>> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counters_.requests_;
+    if (!prefetched_.empty() && prefetched_.front().first == idx) {
+      result = std::move(prefetched_.front().second);
+      prefetched_.pop_front();
+    } else {
+      // the consumer jumped, so nothing queued is useful anymore
+      tasks_.clear();
+      prefetched_.clear();
+    }
+    Refill(idx + 1);
+  }
+  task_available_.notify_all();
+
+  auto start = std::chrono::steady_clock::now();
+  bool starved = false;
+  bool missed = !result.valid();
+  std::vector<af::array> sample;
+  if (missed) {
+    sample = dataset_->get(idx);
+  } else {
+    starved = result.wait_for(std::chrono::seconds(0)) !=
+              std::future_status::ready;
+    sample = result.get();
+  }
+
+  if (starved || missed) {
+    std::chrono::duration<double> waited =
+        std::chrono::steady_clock::now() - start;
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.starved_ += starved ? 1 : 0;
+    counters_.misses_ += missed ? 1 : 0;
+    counters_.wait_seconds_ += waited.count();
+  }
+  return sample;
+}
+
+void PrefetchDataset::Drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  tasks_.clear();
+  prefetched_.clear();
+  task_finished_.wait(lock, [this]() { return running_ == 0; });
+}
+
+void PrefetchDataset::BeginEpoch(size_t epoch) {
+  Drain();
+  WrapperDataset::BeginEpoch(epoch);
+}
+
+PrefetchDataset::Counters PrefetchDataset::GetCounters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return counters_;
+}
+
+void PrefetchDataset::ResetCounters() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_ = {0, 0, 0, 0.0};
+}
+
+void PrefetchDataset::Refill(int64_t next) const {
+  if (!prefetched_.empty()) {
+    next = prefetched_.back().first + 1;
+  }
+  for (; prefetched_.size() < queue_depth_ && next < size(); ++next) {
+    Task task([dataset = dataset_, next]() {
+      auto sample = dataset->get(next);
+      // evaluate here, so the consumer does not run the JIT kernels
+      for (auto& array : sample) {
+        array.eval();
+      }
+      return sample;
+    });
+    prefetched_.emplace_back(next, task.get_future());
+    tasks_.push_back(std::move(task));
+  }
+}
+
+void PrefetchDataset::Work(int device) {
+  af::setDevice(device);
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock, [this]() {
+        return stopped_ || !tasks_.empty();
+      });
+      if (stopped_) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++running_;
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --running_;
+    }
+    task_finished_.notify_all();
+  }
+}
+
+void DrainPrefetch(fl::Dataset& dataset) {
+  if (auto* prefetch = dynamic_cast<PrefetchDataset*>(&dataset)) {
+    prefetch->Drain();
+  }
+  if (auto* wrapper = dynamic_cast<WrapperDataset*>(&dataset)) {
+    DrainPrefetch(*wrapper->GetDataset());
+  }
+}
+
+}  // namespace neurons
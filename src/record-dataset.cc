@@ -0,0 +1,127 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/record-dataset.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neurons {
+
+namespace {
+
+// ArrayFire arrays have four dims, and the last holds the examples.
+const size_t kMaxRecordDims = 3;
+
+// Returns the dims of count records of the passed shape.
+af::dim4 RecordDims(const std::vector<size_t>& shape, size_t count) {
+  if (shape.empty()) {
+    return af::dim4(static_cast<dim_t>(count));
+  }
+  af::dim4 dims(1, 1, 1, static_cast<dim_t>(count));
+  // row-major records are column-major with their dims reversed
+  for (size_t i = 0; i < shape.size(); ++i) {
+    dims[static_cast<unsigned>(i)] =
+        static_cast<dim_t>(shape.at(shape.size() - 1 - i));
+  }
+  return dims;
+}
+
+// Copies count records of type T from the source into a new array.
+template <typename T>
+af::array ReadAs(const RecordSource& source, size_t first, size_t count,
+                 const af::dim4& dims) {
+  std::vector<T> buffer(count * source.GetRecordSize() / sizeof(T));
+  source.ReadRecords(first, count, buffer.data());
+  return af::array(dims, buffer.data());
+}
+
+}  // namespace
+
+RecordDataset::RecordDataset(std::shared_ptr<const RecordSource> inputs,
+    std::shared_ptr<const RecordSource> targets, dim_t batch_size,
+    float offset, float scale)
+    : inputs_(std::move(inputs)), targets_(std::move(targets)),
+      batch_size_(batch_size), offset_(offset), scale_(scale) {
+  if (inputs_ == nullptr || targets_ == nullptr) {
+    throw std::invalid_argument("Dataset sources must not be null.");
+  }
+  if (inputs_->GetRecordCount() != targets_->GetRecordCount()) {
+    throw std::invalid_argument("Dataset example counts do not match.");
+  }
+  if (inputs_->GetRecordShape().size() > kMaxRecordDims ||
+      targets_->GetRecordShape().size() > kMaxRecordDims) {
+    throw std::invalid_argument("Dataset records have too many dims.");
+  }
+  if (batch_size_ <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+}
+
+int64_t RecordDataset::size() const {
+  return (GetExampleCount() + batch_size_ - 1) / batch_size_;
+}
+
+std::vector<af::array> RecordDataset::get(int64_t idx) const {
+  if (idx < 0 || idx >= size()) {
+    throw std::out_of_range("Dataset batch index out of range.");
+  }
+  dim_t begin = idx * batch_size_;
+  dim_t end = std::min(begin + batch_size_, GetExampleCount());
+  auto first = static_cast<size_t>(begin);
+  auto count = static_cast<size_t>(end - begin);
+
+  af::array inputs = ReadRecordArray(*inputs_, first, count);
+  af::array targets = ReadRecordArray(*targets_, first, count);
+  // ArrayFire fuses the cast and rescale into one kernel over the batch
+  inputs = (inputs.as(f32) + offset_) * scale_;
+  if (targets.type() != f32 && targets.type() != f64) {
+    targets = targets.as(s32);
+  }
+  return {inputs, targets};
+}
+
+void RecordDataset::SetBatchSize(dim_t batch_size) {
+  if (batch_size <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+  batch_size_ = batch_size;
+}
+
+dim_t RecordDataset::GetExampleCount() const {
+  return static_cast<dim_t>(inputs_->GetRecordCount());
+}
+
+dim_t RecordDataset::GetBatchSize() const {
+  return batch_size_;
+}
+
+af::array ReadRecordArray(const RecordSource& source, size_t first,
+                          size_t count) {
+  if (source.GetRecordShape().size() > kMaxRecordDims) {
+    throw std::invalid_argument("Records have too many dims.");
+  }
+  af::dim4 dims = RecordDims(source.GetRecordShape(), count);
+  switch (source.GetElementType()) {
+    case ElementType::UInt8:
+      return ReadAs<unsigned char>(source, first, count, dims);
+    case ElementType::Int8: {
+      std::vector<signed char> bytes(count * source.GetRecordSize());
+      source.ReadRecords(first, count, bytes.data());
+      std::vector<short> widened(bytes.begin(), bytes.end());
+      return af::array(dims, widened.data());
+    }
+    case ElementType::Int16:
+      return ReadAs<short>(source, first, count, dims);
+    case ElementType::Int32:
+      return ReadAs<int>(source, first, count, dims);
+    case ElementType::Int64:
+      return ReadAs<long long>(source, first, count, dims);
+    case ElementType::Float32:
+      return ReadAs<float>(source, first, count, dims);
+    case ElementType::Float64:
+      return ReadAs<double>(source, first, count, dims);
+  }
+  throw std::invalid_argument("Records have an unknown element type.");
+}
+
+}  // namespace neurons
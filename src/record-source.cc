@@ -0,0 +1,327 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include "neurons/record-source.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace neurons {
+
+namespace {
+
+// Bytes before the IDX dimension sizes: two zero bytes, type code, dim count
+const size_t kIdxMagicSize = 4;
+const size_t kIdxDimSize = 4;
+// .npy files start with this, then a major and a minor version byte
+const char kNpyMagic[] = "\x93NUMPY";
+const size_t kNpyMagicSize = 6;
+
+bool IsLittleEndian() {
+  const uint16_t probe = 1;
+  unsigned char first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+// Reads size bytes at the start of the file at path.
+// Throws std::runtime_error if the file is shorter or cannot be read.
+std::string ReadPrefix(const std::string& path, size_t size) {
+  std::ifstream file(path, std::ios::binary);
+  std::string prefix(size, '\0');
+  if (!file.read(&prefix[0], static_cast<std::streamsize>(size))) {
+    throw std::runtime_error("[RecordFile] Can't read header of " + path);
+  }
+  return prefix;
+}
+
+// Reads an unsigned integer of size bytes, most significant first if
+// big_endian.
+size_t ReadUnsigned(const std::string& bytes, size_t offset, size_t size,
+                    bool big_endian) {
+  size_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    size_t index = offset + (big_endian ? i : size - 1 - i);
+    value = (value << 8u) | static_cast<unsigned char>(bytes[index]);
+  }
+  return value;
+}
+
+// Returns the element type of an IDX type code.
+// Throws std::runtime_error if the code is unknown.
+ElementType IdxElementType(unsigned char code, const std::string& path) {
+  switch (code) {
+    case 0x08:
+      return ElementType::UInt8;
+    case 0x09:
+      return ElementType::Int8;
+    case 0x0B:
+      return ElementType::Int16;
+    case 0x0C:
+      return ElementType::Int32;
+    case 0x0D:
+      return ElementType::Float32;
+    case 0x0E:
+      return ElementType::Float64;
+    default:
+      throw std::runtime_error("[RecordFile] Unknown IDX element type: " +
+                               path);
+  }
+}
+
+// Returns the text following key and a colon in the .npy header dictionary,
+// up to the next comma outside of parentheses.
+std::string NpyField(const std::string& header, const std::string& key,
+                     const std::string& path) {
+  size_t key_pos = header.find("'" + key + "'");
+  size_t colon = header.find(':', key_pos);
+  if (key_pos == std::string::npos || colon == std::string::npos) {
+    throw std::runtime_error("[RecordFile] .npy header lacks " + key + ": " +
+                             path);
+  }
+  size_t end = colon + 1;
+  size_t depth = 0;
+  for (; end < header.size(); ++end) {
+    char c = header[end];
+    if (c == '(') {
+      ++depth;
+    } else if (c == ')' && depth > 0) {
+      --depth;
+    } else if ((c == ',' && depth == 0) || c == '}') {
+      break;
+    }
+  }
+  std::string value = header.substr(colon + 1, end - colon - 1);
+  // trim spaces and quotes
+  const char* strip = " '\"";
+  size_t first = value.find_first_not_of(strip);
+  size_t last = value.find_last_not_of(strip);
+  return first == std::string::npos ? ""
+                                    : value.substr(first, last - first + 1);
+}
+
+// Returns the element type of a .npy type descriptor, e.g. "<f4", and sets
+// swap_bytes to whether its byte order is not the native one.
+// Throws std::runtime_error if the type is not supported.
+ElementType NpyElementType(const std::string& descr, bool& swap_bytes,
+                           const std::string& path) {
+  if (descr.size() < 3) {
+    throw std::runtime_error("[RecordFile] Bad .npy descr: " + path);
+  }
+  char order = descr[0];
+  std::string kind = descr.substr(1);
+  swap_bytes = (order == '<' && !IsLittleEndian()) ||
+               (order == '>' && IsLittleEndian());
+
+  if (kind == "u1" || kind == "b1") {
+    return ElementType::UInt8;
+  } else if (kind == "i1") {
+    return ElementType::Int8;
+  } else if (kind == "i2") {
+    return ElementType::Int16;
+  } else if (kind == "i4") {
+    return ElementType::Int32;
+  } else if (kind == "i8") {
+    return ElementType::Int64;
+  } else if (kind == "f4") {
+    return ElementType::Float32;
+  } else if (kind == "f8") {
+    return ElementType::Float64;
+  }
+  throw std::runtime_error("[RecordFile] Unsupported .npy type " + descr +
+                           ": " + path);
+}
+
+// Parses a .npy shape tuple, e.g. "(60000, 28, 28)".
+std::vector<size_t> NpyShape(const std::string& tuple,
+                             const std::string& path) {
+  if (tuple.empty() || tuple.front() != '(' || tuple.back() != ')') {
+    throw std::runtime_error("[RecordFile] Bad .npy shape: " + path);
+  }
+  std::vector<size_t> shape;
+  size_t pos = 1;
+  while (pos < tuple.size() - 1) {
+    size_t comma = std::min(tuple.find(',', pos), tuple.size() - 1);
+    std::string dim = tuple.substr(pos, comma - pos);
+    if (dim.find_first_not_of(' ') != std::string::npos) {
+      try {
+        shape.push_back(std::stoul(dim));
+      } catch (const std::exception&) {
+        throw std::runtime_error("[RecordFile] Bad .npy shape: " + path);
+      }
+    }
+    pos = comma + 1;
+  }
+  return shape;
+}
+
+}  // namespace
+
+size_t GetElementSize(ElementType type) {
+  switch (type) {
+    case ElementType::UInt8:
+    case ElementType::Int8:
+      return 1;
+    case ElementType::Int16:
+      return 2;
+    case ElementType::Int32:
+    case ElementType::Float32:
+      return 4;
+    case ElementType::Int64:
+    case ElementType::Float64:
+      return 8;
+  }
+  return 0;
+}
+
+size_t RecordSource::GetRecordSize() const {
+  size_t size = GetElementSize(GetElementType());
+  for (size_t dim : GetRecordShape()) {
+    size *= dim;
+  }
+  return size;
+}
+
+std::unique_ptr<RecordFile> RecordFile::OpenIdx(const std::string& path) {
+  std::string magic = ReadPrefix(path, kIdxMagicSize);
+  if (magic[0] != 0 || magic[1] != 0) {
+    throw std::runtime_error("[RecordFile] Not an IDX file: " + path);
+  }
+  ElementType type = IdxElementType(static_cast<unsigned char>(magic[2]),
+                                    path);
+  size_t dim_count = static_cast<unsigned char>(magic[3]);
+  if (dim_count == 0) {
+    throw std::runtime_error("[RecordFile] IDX file has no records: " + path);
+  }
+
+  size_t header_size = kIdxMagicSize + dim_count * kIdxDimSize;
+  std::string header = ReadPrefix(path, header_size);
+  std::vector<size_t> dims;
+  for (size_t i = 0; i < dim_count; ++i) {
+    dims.push_back(ReadUnsigned(header, kIdxMagicSize + i * kIdxDimSize,
+                                kIdxDimSize, true));
+  }
+
+  // IDX elements are big-endian
+  bool swap_bytes = IsLittleEndian() && GetElementSize(type) > 1;
+  return std::unique_ptr<RecordFile>(new RecordFile(path, header_size, type,
+      std::vector<size_t>(dims.begin() + 1, dims.end()), dims.front(),
+      swap_bytes));
+}
+
+std::unique_ptr<RecordFile> RecordFile::OpenNpy(const std::string& path) {
+  std::string prefix = ReadPrefix(path, kNpyMagicSize + 2);
+  if (prefix.compare(0, kNpyMagicSize, kNpyMagic) != 0) {
+    throw std::runtime_error("[RecordFile] Not a .npy file: " + path);
+  }
+  // version 1 has a 2-byte header length, later versions a 4-byte one
+  size_t length_size = prefix[kNpyMagicSize] == 1 ? 2 : 4;
+  size_t length_offset = kNpyMagicSize + 2;
+  prefix = ReadPrefix(path, length_offset + length_size);
+  size_t header_size = length_offset + length_size +
+      ReadUnsigned(prefix, length_offset, length_size, false);
+  std::string header = ReadPrefix(path, header_size)
+      .substr(length_offset + length_size);
+
+  if (NpyField(header, "fortran_order", path) != "False") {
+    throw std::runtime_error("[RecordFile] .npy array is not C-ordered: " +
+                             path);
+  }
+  bool swap_bytes = false;
+  ElementType type = NpyElementType(NpyField(header, "descr", path),
+                                    swap_bytes, path);
+  std::vector<size_t> shape = NpyShape(NpyField(header, "shape", path), path);
+  if (shape.empty()) {
+    throw std::runtime_error("[RecordFile] .npy array has no records: " +
+                             path);
+  }
+
+  return std::unique_ptr<RecordFile>(new RecordFile(path, header_size, type,
+      std::vector<size_t>(shape.begin() + 1, shape.end()), shape.front(),
+      swap_bytes));
+}
+
+std::unique_ptr<RecordFile> RecordFile::OpenRaw(const std::string& path,
+    ElementType type, const std::vector<size_t>& record_shape,
+    size_t header_size) {
+  // maps nothing, only reads the size
+  size_t file_size = MappedFile(path, 0, 0).GetFileSize();
+  size_t record_size = GetElementSize(type);
+  for (size_t dim : record_shape) {
+    record_size *= dim;
+  }
+  if (file_size < header_size || record_size == 0 ||
+      (file_size - header_size) % record_size != 0) {
+    throw std::runtime_error("[RecordFile] File does not hold whole records: "
+                             + path);
+  }
+  return std::unique_ptr<RecordFile>(new RecordFile(path, header_size, type,
+      record_shape, (file_size - header_size) / record_size, false));
+}
+
+RecordFile::RecordFile(std::string path, size_t data_offset, ElementType type,
+                       std::vector<size_t> record_shape, size_t record_count,
+                       bool swap_bytes)
+    : path_(std::move(path)), file_(path_), data_offset_(data_offset),
+      type_(type), record_shape_(std::move(record_shape)),
+      record_count_(record_count), swap_bytes_(swap_bytes) {
+  size_t file_size = file_.GetFileSize();
+  if (file_size < data_offset_ ||
+      (file_size - data_offset_) / std::max<size_t>(GetRecordSize(), 1) <
+      record_count_) {
+    throw std::runtime_error("[RecordFile] Truncated data: " + path_);
+  }
+}
+
+const std::vector<size_t>& RecordFile::GetRecordShape() const {
+  return record_shape_;
+}
+
+size_t RecordFile::GetRecordCount() const {
+  return record_count_;
+}
+
+ElementType RecordFile::GetElementType() const {
+  return type_;
+}
+
+void RecordFile::ReadRecords(size_t first, size_t count, void* out) const {
+  if (first > record_count_ || count > record_count_ - first) {
+    throw std::out_of_range("Records out of range.");
+  }
+  size_t record_size = GetRecordSize();
+  size_t size = count * record_size;
+  if (size == 0) {
+    return;
+  }
+
+  // only the pages of the requested records are read in
+  auto* bytes = static_cast<unsigned char*>(out);
+  std::memcpy(bytes, file_.GetData() + data_offset_ + first * record_size,
+              size);
+
+  size_t element_size = GetElementSize(type_);
+  if (swap_bytes_ && element_size > 1) {
+    for (size_t i = 0; i < size; i += element_size) {
+      std::reverse(bytes + i, bytes + i + element_size);
+    }
+  }
+}
+
+const std::string& RecordFile::GetPath() const {
+  return path_;
+}
+
+std::unique_ptr<RecordFile> OpenRecordFile(const std::string& path) {
+  const std::string npy = ".npy";
+  if (path.size() >= npy.size() &&
+      path.compare(path.size() - npy.size(), npy.size(), npy) == 0) {
+    return RecordFile::OpenNpy(path);
+  }
+  return RecordFile::OpenIdx(path);
+}
+
+}  // namespace neurons
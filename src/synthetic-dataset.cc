@@ -0,0 +1,93 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/synthetic-dataset.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neurons {
+
+namespace {
+
+// Returns the seed of the generator of the batch at idx. The default
+// ArrayFire engine is counter-based, so nearby seeds give unrelated streams,
+// and the prototypes are generated from seed itself.
+unsigned long long BatchSeed(uint64_t seed, int64_t idx) {
+  return seed + 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(idx + 1);
+}
+
+}  // namespace
+
+SyntheticDataset::SyntheticDataset(const af::dim4& example_dims,
+    int class_count, dim_t example_count, dim_t batch_size, float noise,
+    uint64_t seed)
+    : example_dims_(example_dims), class_count_(class_count),
+      example_count_(example_count), batch_size_(batch_size), noise_(noise),
+      seed_(seed) {
+  if (example_dims_.elements() == 0 || example_dims_[3] != 1) {
+    throw std::invalid_argument("Synthetic examples must be non-empty and "
+                                "have one element along dim 3.");
+  }
+  if (class_count_ <= 0 || example_count_ < 0 || noise_ < 0) {
+    throw std::invalid_argument("Synthetic dataset sizes are out of range.");
+  }
+  if (batch_size_ <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+  af::randomEngine engine(AF_RANDOM_ENGINE_DEFAULT, seed_);
+  prototypes_ = af::randn(af::dim4(example_dims_[0], example_dims_[1],
+                                   example_dims_[2], class_count_),
+                          f32, engine);
+}
+
+SyntheticDataset::SyntheticDataset(const SyntheticDataset& other,
+    dim_t example_count, uint64_t seed)
+    : example_dims_(other.example_dims_), class_count_(other.class_count_),
+      example_count_(example_count), batch_size_(other.batch_size_),
+      noise_(other.noise_), seed_(seed), prototypes_(other.prototypes_) {
+  if (example_count_ < 0) {
+    throw std::invalid_argument("Synthetic dataset sizes are out of range.");
+  }
+}
+
+int64_t SyntheticDataset::size() const {
+  return (example_count_ + batch_size_ - 1) / batch_size_;
+}
+
+std::vector<af::array> SyntheticDataset::get(int64_t idx) const {
+  if (idx < 0 || idx >= size()) {
+    throw std::out_of_range("Dataset batch index out of range.");
+  }
+  dim_t count = std::min(batch_size_, example_count_ - idx * batch_size_);
+
+  af::randomEngine engine(AF_RANDOM_ENGINE_DEFAULT, BatchSeed(seed_, idx));
+  af::array labels =
+      (af::randu(af::dim4(count), u32, engine) % class_count_).as(s32);
+  af::array noise = af::randn(af::dim4(example_dims_[0], example_dims_[1],
+                                       example_dims_[2], count),
+                              f32, engine);
+  af::array inputs =
+      prototypes_(af::span, af::span, af::span, labels) + noise * noise_;
+  return {inputs, labels};
+}
+
+void SyntheticDataset::SetBatchSize(dim_t batch_size) {
+  if (batch_size <= 0) {
+    throw std::invalid_argument("Dataset batch size must be positive.");
+  }
+  batch_size_ = batch_size;
+}
+
+dim_t SyntheticDataset::GetExampleCount() const {
+  return example_count_;
+}
+
+dim_t SyntheticDataset::GetBatchSize() const {
+  return batch_size_;
+}
+
+int SyntheticDataset::GetClassCount() const {
+  return class_count_;
+}
+
+}  // namespace neurons
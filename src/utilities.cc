@@ -2,259 +2,453 @@
 
 #include "neurons/utilities.h"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include "neurons/graph-snapshot.h"
+
 namespace neurons::utilities {
 
-// Get index of element in deque, returns size of deque if not in deque
-template <typename T>
-size_t GetIndex(const std::deque<T>& container, const T& element) {
-  // std::distance will always be non-negative as we start from
-  // container.begin()
-  return static_cast<size_t>(std::distance(container.begin(),
-                    std::find(container.begin(), container.end(), element)));
+// Marks components and cycles that have not been assigned an index
+const size_t kNoIndex = std::numeric_limits<size_t>::max();
+
+size_t AdjacencyList::NodeCount() const {
+  return offsets_.empty() ? 0 : offsets_.size() - 1;
 }
 
-// Get all links leading to or from the passed node
-std::deque<Link> GetNodeLinks(const std::shared_ptr<Node>& node,
-    const std::deque<Link>& links) {
-  std::deque<Link> adjacent_links;
-  for (const auto& link: links) {
-    if (node == link.input_ || node == link.output_) {
-      adjacent_links.push_back(link);
+AdjacencyList BuildAdjacencyList(size_t node_count,
+    const std::vector<size_t>& sources, const std::vector<size_t>& targets) {
+  AdjacencyList adjacency;
+  adjacency.offsets_.assign(node_count + 1, 0);
+
+  // count the out-degree of every node, then prefix sum into offsets
+  for (size_t link = 0; link < sources.size(); ++link) {
+    if (sources.at(link) < node_count && targets.at(link) < node_count) {
+      ++adjacency.offsets_.at(sources.at(link) + 1);
+    }
+  }
+  for (size_t node = 0; node < node_count; ++node) {
+    adjacency.offsets_.at(node + 1) += adjacency.offsets_.at(node);
+  }
+
+  adjacency.targets_.resize(adjacency.offsets_.back());
+  adjacency.links_.resize(adjacency.offsets_.back());
+  std::vector<size_t> next(adjacency.offsets_.begin(),
+                           adjacency.offsets_.end() - 1);
+  for (size_t link = 0; link < sources.size(); ++link) {
+    if (sources.at(link) < node_count && targets.at(link) < node_count) {
+      size_t position = next.at(sources.at(link))++;
+      adjacency.targets_.at(position) = targets.at(link);
+      adjacency.links_.at(position) = link;
     }
   }
-  return adjacent_links;
+  return adjacency;
 }
 
+AdjacencyList BuildAdjacencyList(const NodeDeque& nodes,
+    const std::deque<Link>& links, bool reverse /* = false */) {
+  GraphSnapshot graph(nodes, links);
+  return reverse ? graph.GetInEdges() : graph.GetOutEdges();
+}
 
-bool NodesAndLinksConsistent(const NodeDeque& nodes,
-                             const std::deque<Link>& links) {
+// Uses depth-first search from each unvisited node in index order, visiting
+// neighbors in link order. Nodes are ordered by reverse postorder, so the
+// order is identical to the recursive Kosaraju visit this replaced.
+std::vector<size_t> TopologicalOrder(const AdjacencyList& adjacency) {
+  const size_t node_count = adjacency.NodeCount();
+  std::vector<bool> visited(node_count, false);
+  std::vector<size_t> order;
+  order.reserve(node_count);
 
-  // check all nodes are not nullptr and IDs are unique
-  std::set<size_t> element_ids;
-  for (const auto& node : nodes) {
-    if (node == nullptr) {
-      return false;
+  // explicit stack of (node, position of the next neighbor to visit)
+  std::vector<std::pair<size_t, size_t>> stack;
+
+  for (size_t root = 0; root < node_count; ++root) {
+    if (visited.at(root)) {
+      continue;
     }
-    // check if ID already exists in element_ids
-    if (element_ids.find(node->GetId()) != element_ids.end()) {
-      return false;
+    visited.at(root) = true;
+    stack.emplace_back(root, adjacency.offsets_.at(root));
+
+    while (!stack.empty()) {
+      size_t node = stack.back().first;
+      size_t position = stack.back().second;
+
+      if (position == adjacency.offsets_.at(node + 1)) {
+        // all out-neighbors are finished, so the node is finished
+        order.push_back(node);
+        stack.pop_back();
+        continue;
+      }
+
+      ++stack.back().second;
+      size_t target = adjacency.targets_.at(position);
+      if (!visited.at(target)) {
+        visited.at(target) = true;
+        stack.emplace_back(target, adjacency.offsets_.at(target));
+      }
     }
-    element_ids.insert(node->GetId());
   }
 
-  for (const auto& link : links) {
+  // finished nodes are ordered from output to input nodes
+  std::reverse(order.begin(), order.end());
+  return order;
+}
 
-    // we require that node IDs and link IDs are mutually unique
-    if (element_ids.find(link.GetId()) != element_ids.end()) {
-      return false;
+// Uses Kosaraju's algorithm with implementation derived from:
+// https://en.wikipedia.org/wiki/Kosaraju's_algorithm
+std::vector<size_t> StrongComponents(const AdjacencyList& adjacency,
+                                     const AdjacencyList& reverse) {
+  std::vector<size_t> components(adjacency.NodeCount(), kNoIndex);
+  size_t component_count = 0;
+  std::vector<size_t> stack;
+
+  for (size_t root : TopologicalOrder(adjacency)) {
+    if (components.at(root) != kNoIndex) {
+      continue;
     }
-    element_ids.insert(link.GetId());
-
-    if (std::find(nodes.begin(), nodes.end(), link.input_) == nodes.end() ||
-        std::find(nodes.begin(), nodes.end(), link.output_) == nodes.end()) {
-      return false;
+    // assign every unassigned node that can reach root to its component
+    components.at(root) = component_count;
+    stack.push_back(root);
+    while (!stack.empty()) {
+      size_t node = stack.back();
+      stack.pop_back();
+      for (size_t i = reverse.offsets_.at(node);
+           i < reverse.offsets_.at(node + 1); ++i) {
+        size_t source = reverse.targets_.at(i);
+        if (components.at(source) == kNoIndex) {
+          components.at(source) = component_count;
+          stack.push_back(source);
+        }
+      }
     }
+    ++component_count;
   }
+  return components;
+}
 
-  return true;
+bool IsLossType(NodeType type) {
+  return type == CategoricalCrossEntropy || type == MeanAbsoluteError ||
+         type == MeanSquaredError;
 }
 
-// Helper method for Kosaraju's algorithm
-void Visit(const std::shared_ptr<Node>& node, std::vector<bool>& visited,
-           NodeDeque& stack, const NodeDeque& nodes,
-           const std::deque<Link>& links) {
-  size_t index = GetIndex(nodes, node);
-  if (!visited.at(index)) {
-    // mark node as visited
-    visited.at(index) = true;
-    // visit each of its out-neighbors
-    for (const auto& link : links) {
-      if (link.input_ == node) {
-        Visit(link.output_, visited, stack, nodes, links);
-      }
+// Returns the representative of the node's set, halving paths on the way.
+size_t FindRoot(std::vector<size_t>& parents, size_t node) {
+  while (parents.at(node) != node) {
+    parents.at(node) = parents.at(parents.at(node));
+    node = parents.at(node);
+  }
+  return node;
+}
+
+// Returns whether the node at the passed index has a neighbor other than
+// itself in the AdjacencyList
+bool HasNeighbor(const AdjacencyList& adjacency, size_t node) {
+  for (size_t i = adjacency.offsets_.at(node);
+       i < adjacency.offsets_.at(node + 1); ++i) {
+    if (adjacency.targets_.at(i) != node) {
+      return true;
     }
-    // throw that node onto the stack
-    stack.push_front(node);
   }
+  return false;
 }
 
-// Helper method for Kosaraju's algorithm
-void Assign(const std::shared_ptr<Node>& node, const std::shared_ptr<Node>& root,
-    std::vector<bool>& is_assigned, std::vector<size_t>& assignments,
-    const NodeDeque& nodes, const std::deque<Link>& links) {
+// Returns the NullNode, DuplicateId and ForeignNode violations of the graph
+std::vector<GraphViolation> FindInconsistencies(const GraphSnapshot& graph) {
+  std::vector<GraphViolation> violations;
+  const NodeDeque& nodes = graph.GetNodes();
+  const std::deque<Link>& links = graph.GetLinks();
 
-  size_t index = GetIndex(nodes, node);
-  // if node has not been assigned, assign it to the same component as root
-  if (!is_assigned.at(index)) {
+  // whether each ID already belongs to a node (true) or a link (false)
+  std::unordered_map<size_t, bool> element_ids;
 
-    is_assigned.at(index) = true;
+  for (const auto& node : nodes) {
+    if (node == nullptr) {
+      violations.push_back({NullNode, {}, {}});
+      continue;
+    }
+    if (!element_ids.insert({node->GetId(), true}).second) {
+      violations.push_back({DuplicateId, {node->GetId()}, {}});
+    }
+  }
 
-    size_t root_index = GetIndex(nodes, root);
-    assignments.at(root_index) += 1;
+  for (size_t link = 0; link < links.size(); ++link) {
+    const Link& current = links.at(link);
+
+    // we require that node IDs and link IDs are mutually unique
+    auto id = element_ids.insert({current.GetId(), false});
+    if (!id.second) {
+      if (id.first->second) {
+        violations.push_back({DuplicateId, {current.GetId()},
+                              {current.GetId()}});
+      } else {
+        violations.push_back({DuplicateId, {}, {current.GetId()}});
+      }
+    }
 
-    // assign every input neighbor of the node to the root's component as well
-    for (const auto& link : links) {
-      if (link.output_ == node) {
-        Assign(link.input_, root, is_assigned, assignments, nodes, links);
+    bool foreign_input = graph.GetLinkInput(link) == nodes.size();
+    bool foreign_output = graph.GetLinkOutput(link) == nodes.size();
+    if (foreign_input || foreign_output) {
+      GraphViolation violation = {ForeignNode, {}, {current.GetId()}};
+      if (foreign_input && current.input_ != nullptr) {
+        violation.node_ids_.push_back(current.input_->GetId());
+      }
+      if (foreign_output && current.output_ != nullptr) {
+        violation.node_ids_.push_back(current.output_->GetId());
       }
+      violations.push_back(violation);
+    }
+  }
+  return violations;
+}
+
+// Returns the node indices of every connected component of the graph,
+// ignoring null nodes. Components are ordered by their first node index.
+std::vector<std::vector<size_t>> ConnectedComponents(
+    const GraphSnapshot& graph) {
+  const NodeDeque& nodes = graph.GetNodes();
+  const AdjacencyList& adjacency = graph.GetOutEdges();
+
+  // merge the endpoints of every edge
+  std::vector<size_t> parents(nodes.size());
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    parents.at(node) = node;
+  }
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    for (size_t i = adjacency.offsets_.at(node);
+         i < adjacency.offsets_.at(node + 1); ++i) {
+      parents.at(FindRoot(parents, node)) =
+          FindRoot(parents, adjacency.targets_.at(i));
     }
   }
 
+  // group nodes by the root of their component
+  std::unordered_map<size_t, size_t> component_indices;
+  std::vector<std::vector<size_t>> components;
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    if (nodes.at(node) == nullptr) {
+      continue;
+    }
+    auto component = component_indices.insert(
+        {FindRoot(parents, node), components.size()});
+    if (component.second) {
+      components.emplace_back();
+    }
+    components.at(component.first->second).push_back(node);
+  }
+  return components;
+}
+
+bool NodesAndLinksConsistent(const NodeDeque& nodes,
+                             const std::deque<Link>& links) {
+  return FindInconsistencies(GraphSnapshot(nodes, links)).empty();
 }
 
-// Uses implementation of Kosaraju's algorithm derived from:
-// https://en.wikipedia.org/wiki/Kosaraju's_algorithm
 NodeDeque TopologicalSort(const NodeDeque& nodes,
                           const std::deque<Link>& links) {
-  // nodes are identified by index, as we don't trust node IDs
-  auto visited = std::vector<bool>(nodes.size(), false);
-  NodeDeque stack;
+  return TopologicalSort(GraphSnapshot(nodes, links));
+}
 
-  for (const auto& node : nodes) {
-    // will put all the nodes onto the stack in order of visitation
-    // thus, the stack is ordered from input to output nodes
-    Visit(node, visited, stack, nodes, links);
+NodeDeque TopologicalSort(const GraphSnapshot& graph) {
+  NodeDeque sorted;
+  for (size_t node : graph.GetTopologicalOrder()) {
+    sorted.push_back(graph.GetNodes().at(node));
   }
-
-  return stack;
+  return sorted;
 }
 
-// Uses Kosaraju's algorithm with implementation derived from:
-// https://en.wikipedia.org/wiki/Kosaraju's_algorithm
 bool ContainsDirectedCycle(const NodeDeque& nodes,
     const std::deque<Link>& links) {
-
-  // topologically sorted list (nodes that belong to the same
-  // strong component have arbitrary relative ordering)
-  NodeDeque stack = TopologicalSort(nodes, links);
-
-  // each position with a non-zero value corresponds to a component
-  // the value is the number of nodes in the component
-  auto assignments = std::vector<size_t>(nodes.size(), 0);
-  auto is_assigned = std::vector<bool>(nodes.size(), false);
-
-  for (const auto& node : stack) {
-    // aggregate all the nodes to maximal components
-    Assign(node, node, is_assigned, assignments, nodes, links);
-  }
+  GraphSnapshot graph(nodes, links);
+  std::vector<size_t> components =
+      StrongComponents(graph.GetOutEdges(), graph.GetInEdges());
 
   // check if there are strong components
   // with multiple nodes (i.e. a directed cycle)
-  for (auto assignment : assignments) {
-    if (assignment != 1) {
+  std::vector<size_t> component_sizes(nodes.size(), 0);
+  for (size_t component : components) {
+    if (++component_sizes.at(component) > 1) {
       return true;
     }
   }
   return false;
 }
 
-// Algorithm (implementation detail):
-// S: Set of connected components = { }
-// For each node N in the set A, find all the nodes reachable from N. If any of
-// those nodes are already in a component of S, then continue to next node in
-// A (N is part of a previously discovered component). Otherwise, add this
-// set to S. Returns the number of elements in S.
 size_t CountConnectedComponents(const NodeDeque& nodes,
                                 const std::deque<Link>& links) {
+  return ConnectedComponents(GraphSnapshot(nodes, links)).size();
+}
 
-  size_t connected_components = 0;
-
-  // keeps track of whether search has visited a node
-  // nodes are identified by their index, as we don't trust node IDs
-  std::vector<bool> visited(nodes.size(), false);
+bool AreNodeInputsSatisfied(const NodeDeque& nodes,
+    const std::deque<Link>& links) {
+  GraphSnapshot graph(nodes, links);
 
+  // nodes without a link into them must be data nodes (which have no input)
+  // this does not allow nodes to satisfy themselves as their own input
   for (size_t node = 0; node < nodes.size(); ++node) {
-
-    if (visited.at(node)) {
-      continue;
+    if (!HasNeighbor(graph.GetInEdges(), node) &&
+        nodes.at(node)->GetNodeType() != Dataset) {
+      return false;
     }
-    // if node is unvisited, is not in a previously found connected component
-    ++connected_components;
-    // queue of nodes that are connected to node
-    auto node_queue = std::queue<size_t>();
-    node_queue.push(node);
-    visited[node] = true;
-
-    // while there are still unvisited nodes connected to node
-    while (!node_queue.empty()) {
-      size_t current_node = node_queue.front();
-      node_queue.pop();
-      // traverse all neighboring nodes and see if they've been visited
-      for (const auto& link : GetNodeLinks(nodes.at(current_node), links)) {
-        size_t input_index = GetIndex(nodes, link.input_);
-        size_t output_index = GetIndex(nodes, link.output_);
-
-        // if not visited, then they are not part of a prev. component
-        if (!visited.at(input_index)) {
-          visited.at(input_index) = true;
-          node_queue.push(input_index);
-        }
+  }
+  return true;
+}
 
-        if (!visited.at(output_index)) {
-          visited.at(output_index) = true;
-          node_queue.push(output_index);
-        }
-      }
+bool AreNodeOutputsSatisfied(const NodeDeque& nodes,
+                            const std::deque<Link>& links) {
+  GraphSnapshot graph(nodes, links);
+
+  // nodes without a link from them must be loss nodes (which have no output)
+  // this does not allow nodes to satisfy themselves as their own output
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    if (!HasNeighbor(graph.GetOutEdges(), node) &&
+        !IsLossType(nodes.at(node)->GetNodeType())) {
+      return false;
     }
   }
-  return connected_components;
+  return true;
 }
 
-bool AreNodeInputsSatisfied(const NodeDeque& nodes,
-    const std::deque<Link>& links) {
-  NodeDeque nodes_copy(nodes);
-
-  // go through every link to eliminate nodes that have a link into them
-  for (const auto& link : links) {
-    auto it = nodes_copy.begin();
-    while (it != nodes_copy.end()) {
-      // this does not allow nodes to be satisfy themselves as their own input
-      if (*it == link.output_ && *it != link.input_) {
-        it = nodes_copy.erase(it);
-      } else {
-        ++it;
-      }
-    }
+std::string GraphViolationToString(const GraphViolation& violation) {
+  std::ostringstream output;
+  switch (violation.type_) {
+    case NullNode:
+      output << "Passed nodes and links are inconsistent. Null node.";
+      break;
+    case DuplicateId:
+      output << "Passed nodes and links are inconsistent. Duplicate ID.";
+      break;
+    case ForeignNode:
+      output << "Passed nodes and links are inconsistent. "
+             << "Link to a node outside the graph.";
+      break;
+    case MultipleComponents:
+      output << "Graph does not consist of 1 component.";
+      break;
+    case DirectedCycle:
+      output << "Graph contains a directed cycle.";
+      break;
+    case UnsatisfiedInput:
+      output << "Graph node inputs are not satisfied.";
+      break;
+    case UnsatisfiedOutput:
+      output << "Graph node outputs are not satisfied.";
+      break;
   }
 
-  // remaining nodes in nodes_copy do not have a link leading to them
-  // if they are not data nodes (which do not have input), they are unsatisfied
-  for (const auto& node : nodes_copy) {
-    if (node->GetNodeType() != Dataset) {
-      return false;
+  if (!violation.node_ids_.empty()) {
+    output << " Nodes:";
+    for (size_t id : violation.node_ids_) {
+      output << " " << id;
     }
+    output << ".";
   }
-  return true;
+  if (!violation.link_ids_.empty()) {
+    output << " Links:";
+    for (size_t id : violation.link_ids_) {
+      output << " " << id;
+    }
+    output << ".";
+  }
+  return output.str();
 }
 
+std::vector<GraphViolation> ValidateGraph(const NodeDeque& nodes,
+                                          const std::deque<Link>& links) {
+  return ValidateGraph(GraphSnapshot(nodes, links));
+}
 
-bool AreNodeOutputsSatisfied(const NodeDeque& nodes,
-                            const std::deque<Link>& links) {
-  NodeDeque nodes_copy(nodes);
-
-  // go through every link to eliminate nodes that have a link from them
-  for (const auto& link : links) {
-    auto it = nodes_copy.begin();
-    while (it != nodes_copy.end()) {
-      // this does not allow nodes to be satisfy themselves as their own output
-      if (*it == link.input_ && *it != link.output_) {
-        it = nodes_copy.erase(it);
-      } else {
-        ++it;
+std::vector<GraphViolation> ValidateGraph(const GraphSnapshot& graph) {
+  const NodeDeque& nodes = graph.GetNodes();
+  const std::deque<Link>& links = graph.GetLinks();
+  const AdjacencyList& adjacency = graph.GetOutEdges();
+  const AdjacencyList& reverse = graph.GetInEdges();
+
+  std::vector<GraphViolation> violations = FindInconsistencies(graph);
+
+  // remaining checks only consider non-null nodes and resolved links
+
+  std::vector<std::vector<size_t>> components = ConnectedComponents(graph);
+  if (components.empty()) {
+    violations.push_back({MultipleComponents, {}, {}});
+  } else if (components.size() > 1) {
+    for (const auto& component : components) {
+      GraphViolation violation = {MultipleComponents, {}, {}};
+      for (size_t node : component) {
+        violation.node_ids_.push_back(nodes.at(node)->GetId());
       }
+      violations.push_back(violation);
     }
   }
 
-  // remaining nodes in nodes_copy do not have a link leading to them
-  // if they are not loss nodes (which do not have output), they are unsatisfied
-  for (const auto& node : nodes_copy) {
-    auto type = node->GetNodeType();
-    if (type != CategoricalCrossEntropy && type != MeanAbsoluteError &&
-        type != MeanSquaredError) {
-      return false;
+  // directed cycles: every strong component with more than one node.
+  // self-loops are not considered cycles.
+  // skipped if the graph is known to be acyclic (every node is a component).
+  std::vector<size_t> strong_components(nodes.size());
+  if (graph.IsKnownAcyclic()) {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      strong_components.at(node) = node;
     }
+  } else {
+    strong_components = StrongComponents(adjacency, reverse);
   }
-  return true;
+  std::vector<size_t> component_sizes(nodes.size(), 0);
+  for (size_t component : strong_components) {
+    ++component_sizes.at(component);
+  }
+  // index in cycles of the violation for each strong component
+  std::vector<size_t> cycle_indices(nodes.size(), kNoIndex);
+  std::vector<GraphViolation> cycles;
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    size_t component = strong_components.at(node);
+    if (component_sizes.at(component) < 2) {
+      continue;
+    }
+    if (cycle_indices.at(component) == kNoIndex) {
+      cycle_indices.at(component) = cycles.size();
+      cycles.push_back({DirectedCycle, {}, {}});
+    }
+    cycles.at(cycle_indices.at(component)).node_ids_.push_back(
+        nodes.at(node)->GetId());
+  }
+  for (size_t link = 0; link < links.size(); ++link) {
+    size_t input = graph.GetLinkInput(link);
+    size_t output = graph.GetLinkOutput(link);
+    if (input == nodes.size() || output == nodes.size() || input == output) {
+      continue;
+    }
+    size_t component = strong_components.at(input);
+    if (component == strong_components.at(output) &&
+        cycle_indices.at(component) != kNoIndex) {
+      cycles.at(cycle_indices.at(component)).link_ids_.push_back(
+          links.at(link).GetId());
+    }
+  }
+  violations.insert(violations.end(), cycles.begin(), cycles.end());
+
+  // node inputs and outputs. nodes cannot satisfy themselves.
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    if (nodes.at(node) == nullptr) {
+      continue;
+    }
+    NodeType type = nodes.at(node)->GetNodeType();
+    if (!HasNeighbor(reverse, node) && type != Dataset) {
+      violations.push_back({UnsatisfiedInput, {nodes.at(node)->GetId()}, {}});
+    }
+    if (!HasNeighbor(adjacency, node) && !IsLossType(type)) {
+      violations.push_back(
+          {UnsatisfiedOutput, {nodes.at(node)->GetId()}, {}});
+    }
+  }
+
+  // group the violations by type, keeping discovery order within a type
+  std::stable_sort(violations.begin(), violations.end(),
+      [](const GraphViolation& lhs, const GraphViolation& rhs) {
+        return lhs.type_ < rhs.type_;
+      });
+  return violations;
 }
 
-}  // namespace neurons::utilities
\ No newline at end of file
+}  // namespace neurons::utilities
@@ -0,0 +1,90 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/augment-dataset.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::Augment;
+using neurons::AugmentDataset;
+using neurons::Augmentation;
+
+/*
+ * af::array Augment(const af::array& images,
+ *                   const Augmentation& augmentation,
+ *                   af::randomEngine& engine);
+ */
+TEST_CASE("AugmentDataset: Augment", "[AugmentDataset][Augment]") {
+
+  af::randomEngine engine(AF_RANDOM_ENGINE_DEFAULT, 1);
+  auto images = af::randu(af::dim4(8, 8, 2, 5));
+
+  SECTION("No augmentation keeps the images") {
+    auto result = Augment(images, {0, 0, 0, 0, 0}, engine);
+    REQUIRE(af::allTrue<bool>(result == images));
+  }
+
+  SECTION("Distortions keep the dims") {
+    auto result = Augment(images, {2, 0.3f, 8, 2, 0.1f}, engine);
+    REQUIRE(result.type() == f32);
+    REQUIRE(result.dims() == images.dims());
+    REQUIRE_FALSE(af::allTrue<bool>(result == images));
+  }
+
+  SECTION("Geometric distortions only resample the images") {
+    // a constant image looks the same however it is moved
+    auto constant = af::constant(0.25, af::dim4(8, 8, 1, 5));
+    auto result = Augment(constant, {2, 0.3f, 8, 2, 0}, engine);
+    REQUIRE(af::max<float>(af::abs(result - 0.25)) < 1e-5);
+  }
+
+  SECTION("Vectors are only noised") {
+    auto vectors = af::randu(af::dim4(8, 1, 1, 5));
+    auto result = Augment(vectors, {2, 0.3f, 8, 2, 0}, engine);
+    REQUIRE(af::allTrue<bool>(result == vectors));
+  }
+
+}
+
+/*
+ * std::vector<af::array> get(int64_t idx) const override;
+ * void BeginEpoch(size_t epoch) override;
+ */
+TEST_CASE("AugmentDataset: get", "[AugmentDataset][get]") {
+
+  auto images = af::randu(af::dim4(8, 8, 1, 4));
+  auto labels = af::range(af::dim4(4), 0, s32);
+  auto dataset = std::make_shared<fl::TensorDataset>(
+      std::vector<af::array>{images, labels});
+  const Augmentation augmentation = {2, 0.3f, 8, 2, 0.1f};
+
+  SECTION("Only the inputs are augmented") {
+    AugmentDataset augment(dataset, augmentation, 1);
+    REQUIRE(augment.size() == 4);
+    auto sample = augment.get(1);
+    REQUIRE(sample.at(0).dims() == dataset->get(1).at(0).dims());
+    REQUIRE_FALSE(af::allTrue<bool>(sample.at(0) == dataset->get(1).at(0)));
+    REQUIRE(sample.at(1).scalar<int>() == 1);
+  }
+
+  SECTION("Distortions depend on the seed, epoch and index") {
+    AugmentDataset augment(dataset, augmentation, 1);
+    AugmentDataset same(dataset, augmentation, 1);
+    REQUIRE(af::allTrue<bool>(augment.get(2).at(0) == same.get(2).at(0)));
+
+    auto first = augment.get(2).at(0);
+    augment.BeginEpoch(1);
+    REQUIRE_FALSE(af::allTrue<bool>(augment.get(2).at(0) == first));
+  }
+
+  SECTION("Disabled augmentation serves the wrapped samples") {
+    AugmentDataset augment(dataset, augmentation, 1);
+    augment.SetEnabled(false);
+    REQUIRE(af::allTrue<bool>(augment.get(0).at(0) == dataset->get(0).at(0)));
+  }
+
+  SECTION("Negative amounts") {
+    REQUIRE_THROWS_AS(AugmentDataset(dataset, {-1, 0, 0, 0, 0}, 1),
+                      std::invalid_argument);
+  }
+
+}
@@ -0,0 +1,206 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/byte-image-dataset.h>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+using neurons::ByteImageDataset;
+
+/*
+ * ByteImageDataset(af::array images, af::array labels, dim_t batch_size,
+ *                  float offset, float scale);
+ */
+TEST_CASE("ByteImageDataset: Constructor",
+          "[ByteImageDataset][Constructor]") {
+
+  auto images = (af::randu(2, 2, 1, 5) * 255).as(u8);
+  auto labels = af::range(af::dim4(5), 0, s32);
+
+  SECTION("Valid arguments") {
+    ByteImageDataset dataset(images, labels, 2, 0, 1);
+    REQUIRE(dataset.GetExampleCount() == 5);
+    REQUIRE(dataset.GetBatchSize() == 2);
+    REQUIRE(dataset.size() == 3);
+  }
+
+  SECTION("Images are not bytes") {
+    REQUIRE_THROWS_AS(ByteImageDataset(images.as(f32), labels, 2, 0, 1),
+                      std::invalid_argument);
+  }
+
+  SECTION("Example counts do not match") {
+    REQUIRE_THROWS_AS(ByteImageDataset(images, labels(af::seq(0, 3)), 2, 0, 1),
+                      std::invalid_argument);
+  }
+
+  SECTION("Batch size is not positive") {
+    REQUIRE_THROWS_AS(ByteImageDataset(images, labels, 0, 0, 1),
+                      std::invalid_argument);
+  }
+
+}
+
+/*
+ * std::vector<af::array> get(int64_t idx) const override;
+ */
+TEST_CASE("ByteImageDataset: get", "[ByteImageDataset][get]") {
+
+  std::vector<unsigned char> pixels = {0, 127, 255, 1, 2, 3};
+  af::array images(1, 1, 1, 6, pixels.data());
+  auto labels = af::range(af::dim4(6), 0, s32);
+  ByteImageDataset dataset(images, labels, 4, -127.0f, 1.0f / 255);
+
+  SECTION("Full batch is normalized") {
+    auto batch = dataset.get(0);
+    REQUIRE(batch.size() == 2);
+    REQUIRE(batch.at(0).type() == f32);
+    REQUIRE(batch.at(0).dims() == af::dim4(1, 1, 1, 4));
+    REQUIRE(batch.at(0)(0).scalar<float>() == Approx(-127.0f / 255));
+    REQUIRE(batch.at(0)(1).scalar<float>() == Approx(0.0f));
+    REQUIRE(batch.at(0)(2).scalar<float>() == Approx(128.0f / 255));
+    REQUIRE(af::allTrue<bool>(batch.at(1) == af::range(af::dim4(4), 0, s32)));
+  }
+
+  SECTION("Last batch holds the remaining examples") {
+    auto batch = dataset.get(1);
+    REQUIRE(batch.at(0).dims() == af::dim4(1, 1, 1, 2));
+    REQUIRE(batch.at(1).dims(0) == 2);
+    REQUIRE(batch.at(1)(0).scalar<int>() == 4);
+  }
+
+  SECTION("Index out of range") {
+    REQUIRE_THROWS_AS(dataset.get(2), std::out_of_range);
+    REQUIRE_THROWS_AS(dataset.get(-1), std::out_of_range);
+  }
+
+}
+
+/*
+ * void EnableShuffle(uint64_t seed);
+ * void BeginEpoch(size_t epoch) override;
+ */
+TEST_CASE("ByteImageDataset: Shuffle", "[ByteImageDataset][Shuffle]") {
+
+  // each image holds its own index, so batches show the permutation
+  auto images = af::range(af::dim4(1, 1, 1, 100), 3).as(u8);
+  auto labels = af::range(af::dim4(100), 0, s32);
+  ByteImageDataset dataset(images, labels, 100, 0, 1);
+
+  auto epoch_order = [&dataset]() {
+    auto batch = dataset.get(0);
+    // inputs and labels must stay paired
+    REQUIRE(af::allTrue<bool>(af::flat(batch.at(0)) ==
+                              batch.at(1).as(f32)));
+    std::vector<int> order(100);
+    batch.at(1).host(order.data());
+    return order;
+  };
+
+  std::vector<int> storage_order = epoch_order();
+
+  SECTION("Epochs are permutations of the examples") {
+    dataset.EnableShuffle(1);
+    std::vector<int> first = epoch_order();
+    dataset.BeginEpoch(1);
+    std::vector<int> second = epoch_order();
+
+    REQUIRE(first != storage_order);
+    REQUIRE(first != second);
+    REQUIRE(std::is_permutation(first.begin(), first.end(),
+                                storage_order.begin()));
+    REQUIRE(std::is_permutation(second.begin(), second.end(),
+                                storage_order.begin()));
+  }
+
+  SECTION("Same seed and epoch give the same order") {
+    dataset.EnableShuffle(1);
+    dataset.BeginEpoch(3);
+    std::vector<int> first = epoch_order();
+    dataset.BeginEpoch(4);
+    dataset.BeginEpoch(3);
+    REQUIRE(epoch_order() == first);
+  }
+
+  SECTION("Disabling restores storage order") {
+    dataset.EnableShuffle(1);
+    dataset.DisableShuffle();
+    dataset.BeginEpoch(1);
+    REQUIRE(epoch_order() == storage_order);
+  }
+
+}
+
+/*
+ * ByteImageDataset(const ByteImageDataset& other, dim_t begin, dim_t end);
+ * void SetRange(dim_t begin, dim_t end);
+ */
+TEST_CASE("ByteImageDataset: Views", "[ByteImageDataset][SetRange]") {
+
+  auto images = af::range(af::dim4(1, 1, 1, 10), 3).as(u8);
+  auto labels = af::range(af::dim4(10), 0, s32);
+  ByteImageDataset all(images, labels, 4, 0, 1);
+
+  SECTION("View serves its range of the storage") {
+    ByteImageDataset view(all, 3, 9);
+    REQUIRE(view.SharesStorage(all));
+    REQUIRE(view.GetStorageSize() == 10);
+    REQUIRE(view.GetRangeBegin() == 3);
+    REQUIRE(view.GetExampleCount() == 6);
+    REQUIRE(view.size() == 2);
+    REQUIRE(view.get(0).at(1)(0).scalar<int>() == 3);
+    REQUIRE(view.get(1).at(1).dims(0) == 2);
+    REQUIRE(view.get(1).at(1)(1).scalar<int>() == 8);
+  }
+
+  SECTION("Resized view") {
+    ByteImageDataset view(all, 0, 5);
+    view.SetRange(5, 10);
+    REQUIRE(view.GetExampleCount() == 5);
+    REQUIRE(view.get(0).at(1)(0).scalar<int>() == 5);
+  }
+
+  SECTION("Shuffled view stays in its range") {
+    ByteImageDataset view(all, 6, 10);
+    view.EnableShuffle(1);
+    std::vector<int> order(4);
+    view.get(0).at(1).host(order.data());
+    REQUIRE(std::is_permutation(order.begin(), order.end(),
+                                std::vector<int>{6, 7, 8, 9}.begin()));
+  }
+
+  SECTION("Range out of bounds") {
+    REQUIRE_THROWS_AS(ByteImageDataset(all, 5, 11), std::invalid_argument);
+    REQUIRE_THROWS_AS(all.SetRange(6, 5), std::invalid_argument);
+  }
+
+  SECTION("Separately constructed datasets do not share storage") {
+    ByteImageDataset other(images, labels, 4, 0, 1);
+    REQUIRE_FALSE(other.SharesStorage(all));
+  }
+
+}
+
+/*
+ * void SetBatchSize(dim_t batch_size);
+ */
+TEST_CASE("ByteImageDataset: SetBatchSize",
+          "[ByteImageDataset][SetBatchSize]") {
+
+  auto images = af::range(af::dim4(1, 1, 1, 10), 3).as(u8);
+  auto labels = af::range(af::dim4(10), 0, s32);
+  ByteImageDataset dataset(images, labels, 4, 0, 1);
+
+  SECTION("Examples are rebatched") {
+    dataset.SetBatchSize(5);
+    REQUIRE(dataset.GetBatchSize() == 5);
+    REQUIRE(dataset.size() == 2);
+    REQUIRE(dataset.get(1).at(1)(0).scalar<int>() == 5);
+  }
+
+  SECTION("Batch size is not positive") {
+    REQUIRE_THROWS_AS(dataset.SetBatchSize(0), std::invalid_argument);
+    REQUIRE(dataset.GetBatchSize() == 4);
+  }
+
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/classification-metrics.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::ClassificationMetrics;
+
+/*
+ * explicit ClassificationMetrics(int class_count);
+ */
+TEST_CASE("ClassificationMetrics: Constructor",
+          "[ClassificationMetrics][Constructor]") {
+
+  SECTION("No examples") {
+    auto results = ClassificationMetrics(3).Read();
+    REQUIRE(results.example_count_ == 0);
+    REQUIRE(results.confusion_ == std::vector<size_t>(9, 0));
+    REQUIRE(results.precision_ == std::vector<double>(3, 0));
+  }
+
+  SECTION("Class count is not positive") {
+    REQUIRE_THROWS_AS(ClassificationMetrics(0), std::invalid_argument);
+  }
+
+}
+
+/*
+ * void Add(const af::array& outputs, const af::array& targets,
+ *          const af::array& loss);
+ * Results Read() const;
+ */
+TEST_CASE("ClassificationMetrics: Add", "[ClassificationMetrics][Add]") {
+
+  // scores of 3 classes for 4 examples, predicting 0, 1, 1, 2
+  std::vector<float> scores = {1, 0, 0,
+                               0, 1, 0,
+                               0, 2, 1,
+                               0, 0, 1};
+  af::array outputs(3, 4, scores.data());
+  std::vector<int> labels = {0, 1, 2, 2};
+  af::array targets(4, labels.data());
+  ClassificationMetrics metrics(3);
+
+  SECTION("One batch") {
+    metrics.Add(outputs, targets, af::constant(0.5, 1));
+    auto results = metrics.Read();
+    REQUIRE(results.example_count_ == 4);
+    REQUIRE(results.loss_ == Approx(0.5));
+    REQUIRE(results.error_ == Approx(25));
+    REQUIRE(results.confusion_ == std::vector<size_t>{1, 0, 0,
+                                                      0, 1, 0,
+                                                      0, 1, 1});
+    REQUIRE(results.precision_.at(1) == Approx(0.5));
+    REQUIRE(results.recall_.at(1) == Approx(1));
+    REQUIRE(results.recall_.at(2) == Approx(0.5));
+  }
+
+  SECTION("Losses are weighted by batch size") {
+    metrics.Add(outputs, targets, af::constant(1, 1));
+    metrics.Add(outputs(af::span, af::seq(0, 1)), targets(af::seq(0, 1)),
+                af::constant(4, 1));
+    auto results = metrics.Read();
+    REQUIRE(results.example_count_ == 6);
+    REQUIRE(results.loss_ == Approx(2));
+    REQUIRE(results.error_ == Approx(100.0 / 6));
+  }
+
+  SECTION("Reset clears the totals") {
+    metrics.Add(outputs, targets, af::constant(1, 1));
+    metrics.Reset();
+    REQUIRE(metrics.Read().example_count_ == 0);
+  }
+
+  SECTION("Dims do not match") {
+    REQUIRE_THROWS_AS(metrics.Add(outputs, targets(af::seq(0, 2)),
+                                  af::constant(1, 1)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(ClassificationMetrics(2).Add(outputs, targets,
+                                                   af::constant(1, 1)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Target is not a class") {
+    std::vector<int> bad_labels = {0, 1, 3, 2};
+    REQUIRE_THROWS_AS(metrics.Add(outputs, af::array(4, bad_labels.data()),
+                                  af::constant(1, 1)),
+                      std::invalid_argument);
+    std::vector<int> negative_labels = {0, -1, 2, 2};
+    REQUIRE_THROWS_AS(metrics.Add(outputs,
+                                  af::array(4, negative_labels.data()),
+                                  af::constant(1, 1)),
+                      std::invalid_argument);
+    // nothing was counted
+    REQUIRE(metrics.Read().example_count_ == 0);
+  }
+
+}
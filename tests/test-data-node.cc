@@ -1,8 +1,14 @@
 // Copyright (c) 2020 Simon Liu. All rights reserved.
 
+#include <neurons/augment-dataset.h>
+#include <neurons/byte-image-dataset.h>
 #include <neurons/data-node.h>
+#include <neurons/prefetch-dataset.h>
+#include <neurons/record-dataset.h>
+#include <neurons/synthetic-dataset.h>
 
 #include <catch2/catch.hpp>
+#include <fstream>
 
 TEST_CASE("DataNode: Constructor", "[DataNode][Constructor]") {
   auto train_X = af::randu(1, 2);
@@ -27,4 +33,133 @@ TEST_CASE("DataNode: Constructor", "[DataNode][Constructor]") {
   REQUIRE(node.valid_dataset_->size() == 3);
   REQUIRE(node.test_dataset_->size() == 4);
 
-}
\ No newline at end of file
+}
+TEST_CASE("DataNode: SetValidationSplit", "[DataNode][SetValidationSplit]") {
+  auto images = af::range(af::dim4(1, 1, 1, 10), 3).as(u8);
+  auto labels = af::range(af::dim4(10), 0, s32);
+  auto train = std::make_shared<neurons::ByteImageDataset>(
+      images, labels, 1, 0, 1);
+  auto valid = std::make_unique<neurons::ByteImageDataset>(*train, 0, 2);
+  train->SetRange(2, 10);
+
+  auto node = neurons::DataNode(
+      0, std::make_unique<neurons::PrefetchDataset>(train, 1, 2),
+      std::move(valid),
+      std::make_unique<neurons::ByteImageDataset>(images, labels, 1, 0, 1));
+
+  SECTION("Split is moved") {
+    REQUIRE(node.SetValidationSplit(0.5));
+    REQUIRE(node.valid_dataset_->size() == 5);
+    REQUIRE(node.train_dataset_->size() == 5);
+    REQUIRE(node.train_dataset_->get(0).at(1).scalar<int>() == 5);
+    REQUIRE(node.test_dataset_->size() == 10);
+  }
+
+  SECTION("Fraction out of range") {
+    REQUIRE_FALSE(node.SetValidationSplit(1));
+    REQUIRE_FALSE(node.SetValidationSplit(-0.1));
+    REQUIRE(node.valid_dataset_->size() == 2);
+  }
+
+  SECTION("Sets of different storage") {
+    auto other = neurons::DataNode(
+        1, std::make_unique<neurons::ByteImageDataset>(images, labels, 1, 0, 1),
+        std::make_unique<neurons::ByteImageDataset>(images, labels, 1, 0, 1),
+        std::make_unique<neurons::ByteImageDataset>(images, labels, 1, 0, 1));
+    REQUIRE_FALSE(other.SetValidationSplit(0.5));
+  }
+
+}
+
+TEST_CASE("DataNode: SetBatchSizes", "[DataNode][SetBatchSizes]") {
+  auto images = af::range(af::dim4(1, 1, 1, 12), 3).as(u8);
+  auto labels = af::range(af::dim4(12), 0, s32);
+  auto make_dataset = [&]() {
+    return std::make_unique<neurons::ByteImageDataset>(
+        images, labels, 1, 0, 1);
+  };
+
+  SECTION("Train and evaluation sets are rebatched separately") {
+    auto node = neurons::DataNode(0, std::make_unique<neurons::PrefetchDataset>(
+        make_dataset(), 1, 2), make_dataset(), make_dataset());
+    REQUIRE(node.SetBatchSizes(2, 6));
+    REQUIRE(node.train_dataset_->size() == 6);
+    REQUIRE(node.valid_dataset_->size() == 2);
+    REQUIRE(node.test_dataset_->size() == 2);
+  }
+
+  SECTION("Batch size is not positive") {
+    auto node = neurons::DataNode(0, make_dataset(), make_dataset(),
+                                  make_dataset());
+    REQUIRE_FALSE(node.SetBatchSizes(0, 6));
+    REQUIRE(node.train_dataset_->size() == 12);
+  }
+
+  SECTION("Sets read from record files are rebatched") {
+    const std::string path = "test-data-node-records.bin";
+    {
+      std::ofstream records(path, std::ios::binary | std::ios::trunc);
+      records << std::string(12, 1);
+    }
+    std::shared_ptr<const neurons::RecordFile> inputs =
+        neurons::RecordFile::OpenRaw(path, neurons::ElementType::UInt8, {});
+    auto make_records = [&]() {
+      return std::make_unique<neurons::RecordDataset>(inputs, inputs, 1, 0,
+                                                      1);
+    };
+    auto node = neurons::DataNode(0, std::make_unique<neurons::PrefetchDataset>(
+        make_records(), 1, 2), make_records(), make_records());
+    REQUIRE(node.SetBatchSizes(4, 12));
+    REQUIRE(node.train_dataset_->size() == 3);
+    REQUIRE(node.valid_dataset_->size() == 1);
+    REQUIRE(node.test_dataset_->size() == 1);
+  }
+
+  SECTION("Synthetic sets are rebatched") {
+    auto make_synthetic = [&]() {
+      return std::make_unique<neurons::SyntheticDataset>(af::dim4(2), 3, 12,
+                                                         1, 0.5f, 1);
+    };
+    auto node = neurons::DataNode(0, make_synthetic(), make_synthetic(),
+                                  make_synthetic());
+    REQUIRE(node.SetBatchSizes(4, 6));
+    REQUIRE(node.train_dataset_->size() == 3);
+    REQUIRE(node.test_dataset_->size() == 2);
+  }
+
+  SECTION("Sets cannot be rebatched") {
+    auto node = neurons::DataNode(0, make_dataset(), make_dataset(),
+        std::make_unique<fl::TensorDataset>(
+            fl::TensorDataset({af::randu(1, 4), af::randu(1, 4)})));
+    REQUIRE_FALSE(node.SetBatchSizes(2, 6));
+    REQUIRE(node.train_dataset_->size() == 12);
+  }
+
+}
+
+TEST_CASE("DataNode: SetAugmentation", "[DataNode][SetAugmentation]") {
+  auto images = af::range(af::dim4(4, 4, 1, 6), 0).as(u8);
+  auto labels = af::range(af::dim4(6), 0, s32);
+  auto make_dataset = [&]() {
+    return std::make_unique<neurons::ByteImageDataset>(
+        images, labels, 2, 0, 1);
+  };
+
+  SECTION("Augmentation behind a prefetch is toggled") {
+    auto augment = std::make_shared<neurons::AugmentDataset>(
+        make_dataset(), neurons::Augmentation{0, 0, 0, 0, 1}, 1);
+    auto node = neurons::DataNode(0, std::make_unique<neurons::PrefetchDataset>(
+        augment, 1, 2), make_dataset(), make_dataset());
+    REQUIRE(node.SetAugmentation(false));
+    REQUIRE_FALSE(augment->IsEnabled());
+    REQUIRE(af::allTrue<bool>(node.train_dataset_->get(0).at(0) ==
+                              make_dataset()->get(0).at(0)));
+  }
+
+  SECTION("Train set is not augmented") {
+    auto node = neurons::DataNode(0, make_dataset(), make_dataset(),
+                                  make_dataset());
+    REQUIRE_FALSE(node.SetAugmentation(true));
+  }
+
+}
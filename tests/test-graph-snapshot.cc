@@ -0,0 +1,152 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/graph-snapshot.h>
+#include <neurons/module-node.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::GraphSnapshot;
+using neurons::Link;
+using neurons::ModuleNode;
+
+/*
+ * GraphSnapshot(const NodeDeque& nodes, const std::deque<Link>& links);
+ */
+TEST_CASE("GraphSnapshot: Constructor", "[GraphSnapshot][Constructor]") {
+
+  auto node_one = std::make_shared<ModuleNode>(0, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_three = std::make_shared<ModuleNode>(2, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+
+  SECTION("No nodes or links") {
+    auto graph = GraphSnapshot(neurons::NodeDeque(), std::deque<Link>());
+    REQUIRE(graph.GetNodes().empty());
+    REQUIRE(graph.GetLinks().empty());
+    REQUIRE(graph.GetOutEdges().NodeCount() == 0);
+    REQUIRE(graph.GetInEdges().NodeCount() == 0);
+  }
+
+  SECTION("Copies nodes and links") {
+    neurons::NodeDeque nodes = {node_one, node_two};
+    std::deque<Link> links;
+    links.emplace_back(3, node_one, node_two);
+    auto graph = GraphSnapshot(nodes, links);
+
+    // later changes are not reflected in the snapshot
+    nodes.push_back(node_three);
+    links.emplace_back(4, node_two, node_three);
+
+    REQUIRE(graph.GetNodes().size() == 2);
+    REQUIRE(graph.GetNodes().at(1) == node_two);
+    REQUIRE(graph.GetLinks().size() == 1);
+    REQUIRE(graph.GetLinks().at(0).GetId() == 3);
+  }
+
+  SECTION("Edges in both directions") {
+    neurons::NodeDeque nodes = {node_one, node_two, node_three};
+    std::deque<Link> links;
+    links.emplace_back(3, node_one, node_three);
+    links.emplace_back(4, node_three, node_two);
+    auto graph = GraphSnapshot(nodes, links);
+
+    REQUIRE(graph.GetOutEdges().offsets_ == std::vector<size_t>{0, 1, 1, 2});
+    REQUIRE(graph.GetOutEdges().targets_ == std::vector<size_t>{2, 1});
+    REQUIRE(graph.GetInEdges().offsets_ == std::vector<size_t>{0, 0, 1, 2});
+    REQUIRE(graph.GetInEdges().targets_ == std::vector<size_t>{2, 0});
+  }
+
+}
+
+/*
+ * size_t GetNodeIndex(size_t node_id) const;
+ */
+TEST_CASE("GraphSnapshot: GetNodeIndex", "[GraphSnapshot][GetNodeIndex]") {
+
+  auto node_one = std::make_shared<ModuleNode>(7, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_two = std::make_shared<ModuleNode>(3, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto graph = GraphSnapshot({node_one, node_two}, std::deque<Link>());
+
+  SECTION("Node in snapshot") {
+    REQUIRE(graph.GetNodeIndex(7) == 0);
+    REQUIRE(graph.GetNodeIndex(3) == 1);
+  }
+
+  SECTION("Node not in snapshot") {
+    REQUIRE(graph.GetNodeIndex(0) == 2);
+  }
+
+}
+
+/*
+ * size_t GetLinkInput(size_t link) const;
+ * size_t GetLinkOutput(size_t link) const;
+ */
+TEST_CASE("GraphSnapshot: GetLinkInput and GetLinkOutput",
+    "[GraphSnapshot][GetLinkInput][GetLinkOutput]") {
+
+  auto node_one = std::make_shared<ModuleNode>(0, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto outside = std::make_shared<ModuleNode>(1, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+
+  std::deque<Link> links;
+  links.emplace_back(2, node_two, node_one);
+  links.emplace_back(3, node_one, outside);
+  auto graph = GraphSnapshot({node_one, node_two}, links);
+
+  SECTION("Link between nodes in snapshot") {
+    REQUIRE(graph.GetLinkInput(0) == 1);
+    REQUIRE(graph.GetLinkOutput(0) == 0);
+  }
+
+  SECTION("Link to a node outside the snapshot") {
+    // resolved by address, so the matching ID of outside is not used
+    REQUIRE(graph.GetLinkInput(1) == 0);
+    REQUIRE(graph.GetLinkOutput(1) == 2);
+    REQUIRE(graph.GetOutEdges().targets_ == std::vector<size_t>{0});
+  }
+
+  SECTION("Link index out of range") {
+    REQUIRE_THROWS_AS(graph.GetLinkInput(2), std::out_of_range);
+  }
+
+}
+
+/*
+ * const std::vector<size_t>& GetTopologicalOrder() const;
+ * bool IsKnownAcyclic() const;
+ */
+TEST_CASE("GraphSnapshot: GetTopologicalOrder",
+    "[GraphSnapshot][GetTopologicalOrder][IsKnownAcyclic]") {
+
+  auto node_one = std::make_shared<ModuleNode>(0, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  auto node_three = std::make_shared<ModuleNode>(2, neurons::Linear,
+      std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+  neurons::NodeDeque nodes = {node_one, node_two, node_three};
+  std::deque<Link> links;
+  links.emplace_back(3, node_three, node_one);
+  links.emplace_back(4, node_two, node_one);
+
+  SECTION("Order computed from the graph") {
+    auto graph = GraphSnapshot(nodes, links);
+    REQUIRE(graph.GetTopologicalOrder() == std::vector<size_t>{2, 1, 0});
+    REQUIRE_FALSE(graph.IsKnownAcyclic());
+  }
+
+  SECTION("Order passed on construction") {
+    auto graph = GraphSnapshot(nodes, links, {1, 2, 0});
+    REQUIRE(graph.GetTopologicalOrder() == std::vector<size_t>{1, 2, 0});
+    REQUIRE(graph.IsKnownAcyclic());
+  }
+
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/idx-file.h>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+
+using neurons::IdxFile;
+
+// Writes the bytes to a file at path, replacing any existing file.
+void WriteBytes(const std::string& path,
+                const std::vector<unsigned char>& bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+}
+
+/*
+ * explicit IdxFile(const std::string& path);
+ */
+TEST_CASE("IdxFile: Constructor", "[IdxFile][Constructor]") {
+
+  const std::string path = "test-idx-file.idx";
+
+  SECTION("Valid file") {
+    // 2 x 3 unsigned bytes
+    WriteBytes(path, {0, 0, 0x08, 2, 0, 0, 0, 2, 0, 0, 0, 3,
+                      1, 2, 3, 4, 5, 255});
+    IdxFile idx(path);
+    REQUIRE(idx.GetDims() == std::vector<size_t>{2, 3});
+    REQUIRE(idx.GetElementCount() == 6);
+    REQUIRE(std::vector<unsigned char>(idx.GetData(), idx.GetData() + 6) ==
+            std::vector<unsigned char>{1, 2, 3, 4, 5, 255});
+  }
+
+  SECTION("Missing file") {
+    REQUIRE_THROWS_AS(IdxFile("missing.idx"), std::runtime_error);
+  }
+
+  SECTION("Bad magic") {
+    WriteBytes(path, {1, 0, 0x08, 1, 0, 0, 0, 1, 0});
+    REQUIRE_THROWS_AS(IdxFile(path), std::runtime_error);
+  }
+
+  SECTION("Elements are not unsigned bytes") {
+    WriteBytes(path, {0, 0, 0x0D, 1, 0, 0, 0, 1, 0, 0, 0, 0});
+    REQUIRE_THROWS_AS(IdxFile(path), std::runtime_error);
+  }
+
+  SECTION("Truncated header") {
+    WriteBytes(path, {0, 0, 0x08, 2, 0, 0, 0, 1});
+    REQUIRE_THROWS_AS(IdxFile(path), std::runtime_error);
+  }
+
+  SECTION("Truncated data") {
+    WriteBytes(path, {0, 0, 0x08, 1, 0, 0, 0, 4, 1, 2});
+    REQUIRE_THROWS_AS(IdxFile(path), std::runtime_error);
+  }
+
+  std::remove(path.c_str());
+}
@@ -6,7 +6,7 @@
 #include <catch2/catch.hpp>
 
 /*
- * LinkAdapter::LinkAdapter(Link& link);
+ * LinkAdapter::LinkAdapter(const Link& link, const Handle& handle);
  */
 
 TEST_CASE("LinkAdapter: Constructor", "[LinkAdapter][Constructor]") {
@@ -25,10 +25,11 @@ TEST_CASE("LinkAdapter: Constructor", "[LinkAdapter][Constructor]") {
       std::make_unique<fl::Conv2D>(output_module)));
 
   auto link = neurons::Link(link_id, input_node, output_node);
+  const neurons::Handle handle = {4, 5};
 
-  auto link_adapter = neurons::adapter::LinkAdapter(link);
+  auto link_adapter = neurons::adapter::LinkAdapter(link, handle);
 
-  REQUIRE(link_adapter.link_ == &link);
+  REQUIRE(link_adapter.handle_ == handle);
 
   REQUIRE(link_adapter.id_ ==
           link_id * neurons::adapter::kIdMultiplier);
@@ -39,56 +40,71 @@ TEST_CASE("LinkAdapter: Constructor", "[LinkAdapter][Constructor]") {
 }
 
 /*
- * std::vector<LinkAdapter> BuildLinkAdapters(std::deque<Link>& links);
+ * std::vector<LinkAdapter> BuildLinkAdapters(const Network& network);
  */
 
 TEST_CASE("LinkAdapter: BuildLinkAdapters",
     "[LinkAdapter][BuildLinkAdapters]") {
 
+  auto network = neurons::Network();
+
   SECTION("No Links") {
-    std::deque<neurons::Link> links;
-    REQUIRE(neurons::adapter::BuildLinkAdapters(links).empty());
+    REQUIRE(neurons::adapter::BuildLinkAdapters(network).empty());
   }
 
   SECTION("Multiple Links") {
-    const size_t input_id = 1;
-    const size_t output_id = 2;
-    const size_t link_id = 3;
-    const size_t reverse_link_id = 4;
-
-    auto input_module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
-    auto input_node = std::make_shared<neurons::ModuleNode>(
-        neurons::ModuleNode(input_id, neurons::NodeType::Conv2D,
-            std::make_unique<fl::Conv2D>(input_module)));
-    auto output_module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
-    auto output_node = std::make_shared<neurons::ModuleNode>(
-        neurons::ModuleNode(output_id, neurons::NodeType::Conv2D,
-        std::make_unique<fl::Conv2D>(output_module)));
-
-    auto link = neurons::Link(link_id, input_node, output_node);
-    auto link_reverse = neurons::Link(reverse_link_id, output_node, input_node);
-
-    std::deque<neurons::Link> links = {link, link_reverse};
-    auto link_adapters = neurons::adapter::BuildLinkAdapters(links);
+    auto module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
+    auto input_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    auto middle_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    auto output_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    network.AddLink(input_node, middle_node);
+    network.AddLink(middle_node, output_node);
+    const auto& links = network.GetLinks();
+
+    auto link_adapters = neurons::adapter::BuildLinkAdapters(network);
     REQUIRE(link_adapters.size() == 2);
 
-    REQUIRE(link_adapters.at(0).link_ == &links.at(0));
+    REQUIRE(network.GetLink(link_adapters.at(0).handle_)->GetId() ==
+            links.at(0).GetId());
 
     REQUIRE(link_adapters.at(0).id_ ==
-            link_id * neurons::adapter::kIdMultiplier);
+            links.at(0).GetId() * neurons::adapter::kIdMultiplier);
     REQUIRE(link_adapters.at(0).start_id_ ==
-            input_id * neurons::adapter::kIdMultiplier + 2);
+            input_node->GetId() * neurons::adapter::kIdMultiplier + 2);
     REQUIRE(link_adapters.at(0).end_id_ ==
-            output_id * neurons::adapter::kIdMultiplier + 1);
+            middle_node->GetId() * neurons::adapter::kIdMultiplier + 1);
 
-    REQUIRE(link_adapters.at(1).link_ == &links.at(1));
+    REQUIRE(network.GetLink(link_adapters.at(1).handle_)->GetId() ==
+            links.at(1).GetId());
 
     REQUIRE(link_adapters.at(1).id_ ==
-            reverse_link_id * neurons::adapter::kIdMultiplier);
+            links.at(1).GetId() * neurons::adapter::kIdMultiplier);
     REQUIRE(link_adapters.at(1).start_id_ ==
-            output_id * neurons::adapter::kIdMultiplier + 2);
+            middle_node->GetId() * neurons::adapter::kIdMultiplier + 2);
     REQUIRE(link_adapters.at(1).end_id_ ==
-            input_id * neurons::adapter::kIdMultiplier + 1);
+            output_node->GetId() * neurons::adapter::kIdMultiplier + 1);
+  }
+
+  SECTION("Handles are safe after the network is modified") {
+    auto module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
+    auto input_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    auto output_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    network.AddLink(input_node, output_node);
+
+    auto link_adapters = neurons::adapter::BuildLinkAdapters(network);
+    network.DeleteNode(*output_node);
+    REQUIRE(network.GetLink(link_adapters.at(0).handle_) == nullptr);
+
+    // the freed slot is reused by a new link, but the old handle stays stale
+    auto new_node = network.AddNode(neurons::NodeType::Conv2D,
+        std::make_unique<fl::Conv2D>(module));
+    network.AddLink(input_node, new_node);
+    REQUIRE(network.GetLink(link_adapters.at(0).handle_) == nullptr);
   }
 }
 
@@ -98,25 +114,16 @@ TEST_CASE("LinkAdapter: BuildLinkAdapters",
 
 TEST_CASE("LinkAdapter: FindOwnerLink", "[LinkAdapter][FindOwnerLink]") {
 
-  const size_t input_id = 1;
-  const size_t output_id = 2;
-  const size_t link_id = 3;
-  const size_t reverse_link_id = 4;
-
-  auto input_module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
-  auto input_node = std::make_shared<neurons::ModuleNode>(
-      neurons::ModuleNode(input_id, neurons::NodeType::Conv2D,
-      std::make_unique<fl::Conv2D>(input_module)));
-  auto output_module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
-  auto output_node = std::make_shared<neurons::ModuleNode>(
-      neurons::ModuleNode(output_id, neurons::NodeType::Conv2D,
-      std::make_unique<fl::Conv2D>(output_module)));
-
-  auto link = neurons::Link(link_id, input_node, output_node);
-  auto link_reverse = neurons::Link(reverse_link_id, output_node, input_node);
+  auto network = neurons::Network();
+  auto module = fl::Conv2D(1, 1, 1, 1, 1, 1, 1, 1);
+  auto input_node = network.AddNode(neurons::NodeType::Conv2D,
+      std::make_unique<fl::Conv2D>(module));
+  auto output_node = network.AddNode(neurons::NodeType::Conv2D,
+      std::make_unique<fl::Conv2D>(module));
+  network.AddLink(input_node, output_node);
+  network.AddLink(output_node, output_node);
 
-  std::deque<neurons::Link> links = {link, link_reverse};
-  auto link_adapters = neurons::adapter::BuildLinkAdapters(links);
+  auto link_adapters = neurons::adapter::BuildLinkAdapters(network);
 
   SECTION("Link is present") {
     const auto result = neurons::adapter::FindOwnerLink(link_adapters,
@@ -129,4 +136,4 @@ TEST_CASE("LinkAdapter: FindOwnerLink", "[LinkAdapter][FindOwnerLink]") {
         83472);
     REQUIRE(result == nullptr);
   }
-}
\ No newline at end of file
+}
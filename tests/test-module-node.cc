@@ -126,4 +126,8 @@ TEST_CASE("NodeTypeToString", "[NodeTypeToString][NodeType]") {
     REQUIRE(neurons::NodeTypeToString(
         neurons::NodeType::MeanSquaredError) == "MeanSquaredError");
   }
+  SECTION("Dataset") {
+    REQUIRE(neurons::NodeTypeToString(neurons::NodeType::Dataset) ==
+            "Dataset");
+  }
 }
@@ -12,7 +12,8 @@ using neurons::NetworkContainer;
 using neurons::Link;
 
 /*
- * NetworkContainer(NodeDeque& nodes, const std::deque<Link>& links);
+ * NetworkContainer(const NodeDeque& nodes, const std::deque<Link>& links);
+ * explicit NetworkContainer(const GraphSnapshot& graph);
  */
 
 TEST_CASE("NetworkContainer: Constructor", "[NetworkContainer][Constructor]") {
@@ -109,6 +110,51 @@ TEST_CASE("NetworkContainer: Constructor", "[NetworkContainer][Constructor]") {
     REQUIRE_NOTHROW(NetworkContainer(nodes, links));
   }
 
+  SECTION("Loss node reads the DataNode") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+    auto node_two = std::make_shared<ModuleNode>(1,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    neurons::NodeDeque nodes = {node_one, node_two};
+    std::deque<Link> links;
+    links.emplace_back(2, node_one, node_two);
+    REQUIRE_THROWS_WITH(NetworkContainer(nodes, links),
+        Contains("Loss node cannot read the DataNode."));
+
+    // also rejected alongside a module output
+    auto node_three = std::make_shared<ModuleNode>(3, neurons::Conv2D,
+        std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+    nodes.push_back(node_three);
+    links.emplace_back(4, node_one, node_three);
+    links.emplace_back(5, node_three, node_two);
+    REQUIRE_THROWS_WITH(NetworkContainer(nodes, links),
+        Contains("Loss node cannot read the DataNode."));
+  }
+
+  SECTION("Constructed from a GraphSnapshot") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+    auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(1, 1)));
+    auto node_three = std::make_shared<ModuleNode>(2,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    // nodes are out of topological order in the snapshot
+    neurons::NodeDeque nodes = {node_three, node_two, node_one};
+    std::deque<Link> links;
+    links.emplace_back(3, node_two, node_three);
+    links.emplace_back(4, node_one, node_two);
+    auto container = NetworkContainer(neurons::GraphSnapshot(nodes, links));
+    REQUIRE(container.modules().size() == 1);
+    REQUIRE(container.module(0) == node_two);
+
+    links.pop_front();
+    REQUIRE_THROWS_WITH(
+        NetworkContainer(neurons::GraphSnapshot(nodes, links)),
+        Contains("Graph node inputs are not satisfied. Nodes: 2."));
+  }
+
 }
 
 /*
@@ -258,6 +304,46 @@ TEST_CASE("NetworkContainer: Forward", "[NetworkContainer][Forward]") {
     REQUIRE(output.dims() == expected.dims());
     REQUIRE(fl::allClose(output, expected, 1e-7));
   }
+
+  SECTION("Multi-input network") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+
+    auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 5, false)));
+    node_two->setParams(fl::Variable(af::constant(1, 5, 10, 1), true), 0);
+
+    auto node_three = std::make_shared<ModuleNode>(2, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 5, false)));
+    node_three->setParams(fl::Variable(af::constant(1, 5, 10, 1), true), 0);
+
+    auto node_four = std::make_shared<ModuleNode>(3, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(5, 1, false)));
+    node_four->setParams(fl::Variable(af::constant(1, 1, 5, 1), true), 0);
+
+    auto node_five = std::make_shared<ModuleNode>(4,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    neurons::NodeDeque nodes =
+        {node_one, node_two, node_three, node_four, node_five};
+    std::deque<Link> links;
+    links.emplace_back(5, node_one, node_two);
+    links.emplace_back(6, node_one, node_three);
+    links.emplace_back(7, node_two, node_four);
+    links.emplace_back(8, node_three, node_four);
+    links.emplace_back(9, node_four, node_five);
+
+    auto network = NetworkContainer(nodes, links);
+    auto output = network.forward(
+        fl::input(af::constant(1, 10, 1, 1, 1)));
+
+    // node_four sums the outputs of node_two and node_three
+    auto expected = fl::Variable(
+        af::constant(100, 1, 1, 1, 1), false);
+
+    REQUIRE(output.dims() == expected.dims());
+    REQUIRE(fl::allClose(output, expected, 1e-7));
+  }
 }
 
 /*
@@ -336,6 +422,88 @@ TEST_CASE("NetworkContainer: operator()", "[NetworkContainer][operator]") {
   }
 }
 
+/*
+ * size_t GetPeakSlotBytes() const;
+ */
+
+TEST_CASE("NetworkContainer: GetPeakSlotBytes",
+    "[NetworkContainer][GetPeakSlotBytes]") {
+
+  SECTION("No forward pass") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+    auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 1, false)));
+    auto node_three = std::make_shared<ModuleNode>(2,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    neurons::NodeDeque nodes = {node_one, node_two, node_three};
+    std::deque<Link> links;
+    links.emplace_back(3, node_one, node_two);
+    links.emplace_back(4, node_two, node_three);
+
+    auto network = NetworkContainer(nodes, links);
+    REQUIRE(network.GetPeakSlotBytes() == 0);
+  }
+
+  SECTION("Consumed outputs are released") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+    auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 10, false)));
+    auto node_three = std::make_shared<ModuleNode>(2, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 10, false)));
+    auto node_four = std::make_shared<ModuleNode>(3, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 1, false)));
+    auto node_five = std::make_shared<ModuleNode>(4,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    neurons::NodeDeque nodes =
+        {node_one, node_two, node_three, node_four, node_five};
+    std::deque<Link> links;
+    links.emplace_back(5, node_one, node_two);
+    links.emplace_back(6, node_two, node_three);
+    links.emplace_back(7, node_three, node_four);
+    links.emplace_back(8, node_four, node_five);
+
+    auto network = NetworkContainer(nodes, links);
+    network.eval();
+    network.forward(fl::noGrad(af::constant(1, 10, 1, 1, 1)));
+
+    // at most two 10-element f32 outputs are ever held in slots at once
+    REQUIRE(network.GetPeakSlotBytes() == 2 * 10 * sizeof(float));
+  }
+
+  SECTION("Outputs read by later modules are kept") {
+    auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+    auto node_two = std::make_shared<ModuleNode>(1, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 10, false)));
+    auto node_three = std::make_shared<ModuleNode>(2, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 10, false)));
+    auto node_four = std::make_shared<ModuleNode>(3, neurons::Linear,
+        std::make_unique<fl::Linear>(fl::Linear(10, 10, false)));
+    auto node_five = std::make_shared<ModuleNode>(4,
+        neurons::CategoricalCrossEntropy,
+        std::make_unique<fl::CategoricalCrossEntropy>());
+
+    neurons::NodeDeque nodes =
+        {node_one, node_two, node_three, node_four, node_five};
+    std::deque<Link> links;
+    links.emplace_back(5, node_one, node_two);
+    links.emplace_back(6, node_two, node_three);
+    links.emplace_back(7, node_three, node_four);
+    // residual link keeps node_two alive until node_four has run
+    links.emplace_back(8, node_two, node_four);
+    links.emplace_back(9, node_four, node_five);
+
+    auto network = NetworkContainer(nodes, links);
+    network.eval();
+    network.forward(fl::noGrad(af::constant(1, 10, 1, 1, 1)));
+
+    REQUIRE(network.GetPeakSlotBytes() == 3 * 10 * sizeof(float));
+  }
+}
+
 /*
  * std::string prettyString() const override;
  */
@@ -0,0 +1,219 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/network-spec.h>
+#include <neurons/utilities.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+
+using neurons::NetworkSpec;
+
+namespace {
+
+NetworkSpec Parse(const std::string& text) {
+  std::istringstream input(text);
+  return neurons::ParseNetworkSpec(input);
+}
+
+}  // namespace
+
+/*
+ * NetworkSpec ParseNetworkSpec(std::istream& input);
+ */
+TEST_CASE("NetworkSpec: ParseNetworkSpec",
+          "[NetworkSpec][ParseNetworkSpec]") {
+
+  SECTION("Valid spec") {
+    auto spec = Parse("# comment\n"
+                      "node hidden Linear 4 2 1  # trailing comment\n"
+                      "\n"
+                      "node activation ReLU\n"
+                      "link data hidden\n"
+                      "link hidden activation\n"
+                      "optimizer SGDOptimizer 0.1 0 0 0\n");
+    REQUIRE(spec.nodes_.size() == 2);
+    REQUIRE(spec.nodes_.at(0).name_ == "hidden");
+    REQUIRE(spec.nodes_.at(0).type_ == neurons::NodeType::Linear);
+    REQUIRE(spec.nodes_.at(0).args_ == std::vector<double>{4, 2, 1});
+    REQUIRE(spec.nodes_.at(1).args_.empty());
+    REQUIRE(spec.links_.size() == 2);
+    REQUIRE(spec.links_.at(0).first == "data");
+    REQUIRE(spec.links_.at(0).second == "hidden");
+    REQUIRE(spec.optimizer_.name_ == "SGDOptimizer");
+    REQUIRE(spec.optimizer_.args_.size() == 4);
+  }
+
+  SECTION("Unknown node type") {
+    REQUIRE_THROWS_AS(Parse("node a Softmax\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(Parse("node a Dataset\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+  }
+
+  SECTION("Repeated node name") {
+    REQUIRE_THROWS_AS(Parse("node a ReLU\nnode a Tanh\n"
+                            "optimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(Parse("node data ReLU\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+  }
+
+  SECTION("Malformed statements") {
+    REQUIRE_THROWS_AS(Parse("node a Linear 4 x 1\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(Parse("link a\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(Parse("layer a ReLU\noptimizer SGDOptimizer\n"),
+                      std::invalid_argument);
+  }
+
+  SECTION("Missing or repeated optimizer") {
+    REQUIRE_THROWS_AS(Parse("node a ReLU\n"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Parse("optimizer SGDOptimizer\n"
+                            "optimizer AdamOptimizer\n"),
+                      std::invalid_argument);
+  }
+
+}
+
+/*
+ * std::unique_ptr<fl::Module> MakeModule(NodeType type,
+ *     const std::vector<double>& args);
+ */
+TEST_CASE("NetworkSpec: MakeModule", "[NetworkSpec][MakeModule]") {
+
+  SECTION("Valid arguments") {
+    REQUIRE(neurons::MakeModule(neurons::NodeType::Linear, {4, 2, 1}) !=
+            nullptr);
+    REQUIRE(neurons::MakeModule(neurons::NodeType::ReLU, {}) != nullptr);
+    REQUIRE(neurons::MakeModule(neurons::NodeType::View, {4, -1, 1, 1}) !=
+            nullptr);
+    REQUIRE(neurons::MakeModule(neurons::NodeType::Pool2D,
+                                {2, 2, 2, 2, 0, 0, 1}) != nullptr);
+  }
+
+  SECTION("Wrong number of arguments") {
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Linear, {4, 2}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::ReLU, {1}),
+                      std::invalid_argument);
+  }
+
+  SECTION("Arguments out of range") {
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Linear,
+                                          {0, 2, 1}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Linear,
+                                          {4.5, 2, 1}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Dropout, {1}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::View,
+                                          {-1, -1, 1, 1}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Pool2D,
+                                          {2, 2, 2, 2, 0, 0, 3}),
+                      std::invalid_argument);
+  }
+
+  SECTION("Type without a module") {
+    REQUIRE_THROWS_AS(neurons::MakeModule(neurons::NodeType::Dummy, {}),
+                      std::invalid_argument);
+  }
+
+}
+
+/*
+ * void BuildNetwork(const NetworkSpec& spec, Network& network);
+ */
+TEST_CASE("NetworkSpec: BuildNetwork", "[NetworkSpec][BuildNetwork]") {
+
+  neurons::Network network;
+  auto examples = af::randu(4, 3);
+  auto labels = af::range(af::dim4(3), 0, s32);
+  network.AddNode(
+      std::make_unique<fl::TensorDataset>(std::vector<af::array>{examples,
+                                                                 labels}),
+      std::make_unique<fl::TensorDataset>(std::vector<af::array>{examples,
+                                                                 labels}),
+      std::make_unique<fl::TensorDataset>(std::vector<af::array>{examples,
+                                                                 labels}));
+
+  SECTION("Nodes and links are added") {
+    auto spec = Parse("node hidden Linear 4 2 1\n"
+                      "node softmax LogSoftmax\n"
+                      "link data hidden\n"
+                      "link hidden softmax\n"
+                      "optimizer SGDOptimizer 0.1 0 0 0\n");
+    neurons::BuildNetwork(spec, network);
+    REQUIRE(network.GetNodes().size() == 3);
+    REQUIRE(network.GetLinks().size() == 2);
+  }
+
+  SECTION("Link names an unknown node") {
+    auto spec = Parse("node hidden Linear 4 2 1\n"
+                      "link data output\n"
+                      "optimizer SGDOptimizer 0.1 0 0 0\n");
+    REQUIRE_THROWS_AS(neurons::BuildNetwork(spec, network),
+                      std::invalid_argument);
+  }
+
+  SECTION("Link creates a cycle") {
+    auto spec = Parse("node a ReLU\n"
+                      "node b ReLU\n"
+                      "link a b\n"
+                      "link b a\n"
+                      "optimizer SGDOptimizer 0.1 0 0 0\n");
+    REQUIRE_THROWS_AS(neurons::BuildNetwork(spec, network),
+                      std::invalid_argument);
+  }
+
+  SECTION("Shipped example spec builds a valid network") {
+    auto spec = neurons::LoadNetworkSpec(
+        std::string(NEURONS_SOURCE_DIR) + "/trainer/mnist-mlp.spec");
+    neurons::BuildNetwork(spec, network);
+    REQUIRE(neurons::utilities::ValidateGraph(*network.GetSnapshot())
+                .empty());
+  }
+
+  SECTION("Network without a DataNode") {
+    neurons::Network empty;
+    REQUIRE_THROWS_AS(neurons::BuildNetwork(Parse("optimizer SGDOptimizer\n"),
+                                            empty),
+                      std::invalid_argument);
+  }
+
+}
+
+/*
+ * std::shared_ptr<fl::FirstOrderOptimizer> MakeOptimizer(
+ *     const NetworkSpec::OptimizerSpec& spec,
+ *     const std::vector<fl::Variable>& params);
+ */
+TEST_CASE("NetworkSpec: MakeOptimizer", "[NetworkSpec][MakeOptimizer]") {
+
+  fl::Linear linear(4, 2);
+
+  SECTION("Valid optimizers") {
+    REQUIRE(neurons::MakeOptimizer({"AdamOptimizer", {0.001, 0.9, 0.999,
+                                                      1e-8, 0}},
+                                   linear.params()) != nullptr);
+    REQUIRE(neurons::MakeOptimizer({"SGDOptimizer", {0.1, 0.9, 0, 1}},
+                                   linear.params()) != nullptr);
+  }
+
+  SECTION("Unknown optimizer") {
+    REQUIRE_THROWS_AS(neurons::MakeOptimizer({"LBFGS", {}}, linear.params()),
+                      std::invalid_argument);
+  }
+
+  SECTION("Invalid arguments") {
+    REQUIRE_THROWS_AS(neurons::MakeOptimizer({"SGDOptimizer", {0.1}},
+                                             linear.params()),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(neurons::MakeOptimizer({"SGDOptimizer", {0, 0, 0, 0}},
+                                             linear.params()),
+                      std::invalid_argument);
+  }
+
+}
@@ -215,6 +215,110 @@ TEST_CASE("Network: Add Links", "[Network][AddLink]") {
                 std::make_unique<fl::Linear>(mod)))) == nullptr);
   }
 
+  SECTION("Adding a link that forms a directed cycle (invalid)") {
+    network.AddLink(network.GetNodes().at(0), network.GetNodes().at(1));
+    REQUIRE(network.AddLink(network.GetNodes().at(1),
+                            network.GetNodes().at(0)) == nullptr);
+    REQUIRE(network.GetLinks().size() == 1);
+  }
+
+  SECTION("Adding a link against the order of node creation") {
+    // node 1 must now be ordered before node 0
+    REQUIRE(network.AddLink(network.GetNodes().at(1),
+                            network.GetNodes().at(0)) != nullptr);
+    REQUIRE(network.AddLink(network.GetNodes().at(0),
+                            network.GetNodes().at(1)) == nullptr);
+  }
+
+  SECTION("Adding a node linked to itself") {
+    REQUIRE(network.AddLink(network.GetNodes().at(0),
+                            network.GetNodes().at(0)) != nullptr);
+  }
+
+}
+
+/*
+ * Link* AddLink(const std::shared_ptr<Node>& input,
+ *     const std::shared_ptr<Node>& output, LinkRejection& rejection);
+ */
+TEST_CASE("Network: Add Links with rejection", "[Network][AddLink]") {
+
+  neurons::Network network;
+
+  auto module = fl::Linear(1, 1);
+  for (size_t i = 0; i < 5; ++i) {
+    network.AddNode(neurons::NodeType::Linear,
+                    std::make_unique<fl::Linear>(module));
+  }
+  const auto& nodes = network.GetNodes();
+  neurons::LinkRejection rejection;
+
+  SECTION("Accepted link") {
+    REQUIRE(network.AddLink(nodes.at(0), nodes.at(1), rejection) != nullptr);
+    REQUIRE(rejection == neurons::LinkAccepted);
+  }
+
+  SECTION("Node not in network") {
+    auto outside = std::make_shared<neurons::ModuleNode>(
+        neurons::ModuleNode(10, neurons::NodeType::Linear,
+            std::make_unique<fl::Linear>(module)));
+    REQUIRE(network.AddLink(nodes.at(0), outside, rejection) == nullptr);
+    REQUIRE(rejection == neurons::LinkNodeMissing);
+  }
+
+  SECTION("Long cycle built against the order of node creation") {
+    // 4 -> 3 -> 2 -> 1 -> 0
+    for (size_t i = 4; i > 0; --i) {
+      REQUIRE(network.AddLink(nodes.at(i), nodes.at(i - 1),
+                              rejection) != nullptr);
+    }
+    REQUIRE(network.AddLink(nodes.at(0), nodes.at(4), rejection) == nullptr);
+    REQUIRE(rejection == neurons::LinkCreatesCycle);
+    REQUIRE(neurons::LinkRejectionToString(rejection) ==
+            "Link rejected: link would create a directed cycle.");
+
+    // shortcuts that follow the order are still accepted
+    REQUIRE(network.AddLink(nodes.at(3), nodes.at(0), rejection) != nullptr);
+  }
+
+  SECTION("Deleting a link allows the reverse link") {
+    network.AddLink(nodes.at(0), nodes.at(1), rejection);
+    network.AddLink(nodes.at(1), nodes.at(2), rejection);
+    REQUIRE(network.AddLink(nodes.at(2), nodes.at(0), rejection) == nullptr);
+
+    network.DeleteLink(network.GetLinks().at(1));
+    REQUIRE(network.AddLink(nodes.at(2), nodes.at(0), rejection) != nullptr);
+    REQUIRE(rejection == neurons::LinkAccepted);
+  }
+
+  SECTION("Deleting a node allows the reverse link") {
+    network.AddLink(nodes.at(0), nodes.at(1), rejection);
+    network.AddLink(nodes.at(1), nodes.at(2), rejection);
+    network.DeleteNode(*nodes.at(1));
+    // nodes are now 0, 2, 3, 4
+    const auto& remaining = network.GetNodes();
+    REQUIRE(remaining.size() == 4);
+    REQUIRE(network.AddLink(remaining.at(1), remaining.at(0),
+                            rejection) != nullptr);
+  }
+
+  SECTION("Snapshot is known to be acyclic") {
+    network.AddLink(nodes.at(3), nodes.at(1), rejection);
+    network.AddLink(nodes.at(1), nodes.at(0), rejection);
+    auto snapshot = network.GetSnapshot();
+    REQUIRE(snapshot->IsKnownAcyclic());
+
+    // every link goes forward in the order
+    std::vector<size_t> positions(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      positions.at(snapshot->GetTopologicalOrder().at(i)) = i;
+    }
+    for (size_t link = 0; link < snapshot->GetLinks().size(); ++link) {
+      REQUIRE(positions.at(snapshot->GetLinkInput(link)) <
+              positions.at(snapshot->GetLinkOutput(link)));
+    }
+  }
+
 }
 
 /*
@@ -271,4 +375,221 @@ TEST_CASE("Network: Get Loss ModuleNode", "[Network][GetLossNode]") {
     network.DeleteNode(*network.GetLossNode());
     REQUIRE(network.GetLossNode() == nullptr);
   }
-}
\ No newline at end of file
+  SECTION("Deleting the loss node falls back to the next loss node") {
+    auto first = network.AddNode(neurons::NodeType::MeanSquaredError,
+        std::make_unique<fl::MeanSquaredError>());
+    auto second = network.AddNode(neurons::NodeType::MeanAbsoluteError,
+        std::make_unique<fl::MeanAbsoluteError>());
+    REQUIRE(network.GetLossNode() == first);
+    network.DeleteNode(*first);
+    REQUIRE(network.GetLossNode() == second);
+  }
+}
+
+/*
+ * std::shared_ptr<const GraphSnapshot> GetSnapshot() const;
+ */
+
+TEST_CASE("Network: Get Snapshot", "[Network][GetSnapshot]") {
+
+  neurons::Network network;
+
+  auto module = fl::Linear(1, 1);
+  network.AddNode(neurons::NodeType::Linear,
+                  std::make_unique<fl::Linear>(module));
+  network.AddNode(neurons::NodeType::Linear,
+                  std::make_unique<fl::Linear>(module));
+
+  SECTION("Snapshot matches the network") {
+    network.AddLink(network.GetNodes().at(0), network.GetNodes().at(1));
+    auto snapshot = network.GetSnapshot();
+    REQUIRE(snapshot->GetNodes() == network.GetNodes());
+    REQUIRE(snapshot->GetLinks().size() == 1);
+    REQUIRE(snapshot->GetLinkInput(0) == 0);
+    REQUIRE(snapshot->GetLinkOutput(0) == 1);
+  }
+
+  SECTION("Snapshot is reused while the network is unchanged") {
+    REQUIRE(network.GetSnapshot() == network.GetSnapshot());
+  }
+
+  SECTION("Snapshot is rebuilt after adding a link") {
+    auto snapshot = network.GetSnapshot();
+    network.AddLink(network.GetNodes().at(0), network.GetNodes().at(1));
+    REQUIRE(network.GetSnapshot() != snapshot);
+    REQUIRE(network.GetSnapshot()->GetLinks().size() == 1);
+    // old snapshots are left unchanged
+    REQUIRE(snapshot->GetLinks().empty());
+  }
+
+  SECTION("Snapshot is rebuilt after deleting a link") {
+    network.AddLink(network.GetNodes().at(0), network.GetNodes().at(1));
+    auto snapshot = network.GetSnapshot();
+    network.DeleteLink(network.GetLinks().at(0));
+    REQUIRE(network.GetSnapshot() != snapshot);
+    REQUIRE(network.GetSnapshot()->GetLinks().empty());
+  }
+
+  SECTION("Snapshot is rebuilt after adding and deleting nodes") {
+    auto snapshot = network.GetSnapshot();
+    network.AddNode(neurons::NodeType::Linear,
+                    std::make_unique<fl::Linear>(module));
+    REQUIRE(network.GetSnapshot()->GetNodes().size() == 3);
+
+    network.DeleteNode(*network.GetNodes().at(0));
+    REQUIRE(network.GetSnapshot()->GetNodes().size() == 2);
+    REQUIRE(snapshot->GetNodes().size() == 2);
+  }
+}
+
+/*
+ * size_t CountComponents() const;
+ * size_t GetComponentId(size_t node_id) const;
+ */
+
+TEST_CASE("Network: Connected components",
+    "[Network][CountComponents][GetComponentId]") {
+
+  neurons::Network network;
+
+  SECTION("Empty network") {
+    REQUIRE(network.CountComponents() == 0);
+    REQUIRE_THROWS_AS(network.GetComponentId(0), std::out_of_range);
+  }
+
+  auto module = fl::Linear(1, 1);
+  for (size_t i = 0; i < 4; ++i) {
+    network.AddNode(neurons::NodeType::Linear,
+                    std::make_unique<fl::Linear>(module));
+  }
+  const auto& nodes = network.GetNodes();
+
+  SECTION("Unlinked nodes are separate components") {
+    REQUIRE(network.CountComponents() == 4);
+    REQUIRE(network.GetComponentId(nodes.at(0)->GetId()) !=
+            network.GetComponentId(nodes.at(1)->GetId()));
+  }
+
+  SECTION("Links merge components regardless of direction") {
+    network.AddLink(nodes.at(0), nodes.at(1));
+    network.AddLink(nodes.at(3), nodes.at(1));
+    REQUIRE(network.CountComponents() == 2);
+    REQUIRE(network.GetComponentId(nodes.at(0)->GetId()) ==
+            network.GetComponentId(nodes.at(3)->GetId()));
+    REQUIRE(network.GetComponentId(nodes.at(0)->GetId()) !=
+            network.GetComponentId(nodes.at(2)->GetId()));
+  }
+
+  SECTION("Deleting a link splits a component") {
+    network.AddLink(nodes.at(0), nodes.at(1));
+    network.AddLink(nodes.at(1), nodes.at(2));
+    network.AddLink(nodes.at(2), nodes.at(3));
+    REQUIRE(network.CountComponents() == 1);
+
+    network.DeleteLink(network.GetLinks().at(1));
+    REQUIRE(network.CountComponents() == 2);
+    REQUIRE(network.GetComponentId(nodes.at(0)->GetId()) ==
+            network.GetComponentId(nodes.at(1)->GetId()));
+    REQUIRE(network.GetComponentId(nodes.at(1)->GetId()) !=
+            network.GetComponentId(nodes.at(2)->GetId()));
+
+    // the rebuilt components are updated by later additions
+    network.AddLink(nodes.at(0), nodes.at(3));
+    REQUIRE(network.CountComponents() == 1);
+  }
+
+  SECTION("Deleting a node splits a component") {
+    network.AddLink(nodes.at(0), nodes.at(1));
+    network.AddLink(nodes.at(1), nodes.at(2));
+    size_t deleted_id = nodes.at(1)->GetId();
+    network.DeleteNode(*nodes.at(1));
+    // nodes are now 0, 2, 3
+    REQUIRE(network.CountComponents() == 3);
+    REQUIRE_THROWS_AS(network.GetComponentId(deleted_id), std::out_of_range);
+
+    network.AddNode(neurons::NodeType::Linear,
+                    std::make_unique<fl::Linear>(module));
+    REQUIRE(network.CountComponents() == 4);
+  }
+
+}
+
+/*
+ * bool ContainsNode(const std::shared_ptr<Node>& node) const;
+ * std::shared_ptr<Node> GetNode(size_t node_id) const;
+ */
+
+TEST_CASE("Network: Node lookup", "[Network][ContainsNode][GetNode]") {
+
+  neurons::Network network;
+
+  auto module = fl::Linear(1, 1);
+  auto node = network.AddNode(neurons::NodeType::Linear,
+                              std::make_unique<fl::Linear>(module));
+
+  SECTION("Node in network") {
+    REQUIRE(network.ContainsNode(node));
+    REQUIRE(network.GetNode(node->GetId()) == node);
+  }
+
+  SECTION("Node with the same ID outside the network") {
+    auto outside = std::make_shared<neurons::ModuleNode>(
+        neurons::ModuleNode(node->GetId(), neurons::NodeType::Linear,
+            std::make_unique<fl::Linear>(module)));
+    REQUIRE_FALSE(network.ContainsNode(outside));
+    REQUIRE_FALSE(network.ContainsNode(nullptr));
+  }
+
+  SECTION("Deleted node") {
+    network.DeleteNode(*node);
+    REQUIRE_FALSE(network.ContainsNode(node));
+    REQUIRE(network.GetNode(node->GetId()) == nullptr);
+  }
+
+}
+
+/*
+ * void DeleteNodes(const std::vector<size_t>& node_ids);
+ * void DeleteLinks(const std::vector<size_t>& link_ids);
+ */
+
+TEST_CASE("Network: Bulk deletion", "[Network][DeleteNodes][DeleteLinks]") {
+
+  neurons::Network network;
+
+  auto module = fl::Linear(1, 1);
+  for (size_t i = 0; i < 4; ++i) {
+    network.AddNode(neurons::NodeType::Linear,
+                    std::make_unique<fl::Linear>(module));
+  }
+  const auto& nodes = network.GetNodes();
+  network.AddLink(nodes.at(0), nodes.at(1));
+  network.AddLink(nodes.at(1), nodes.at(2));
+  network.AddLink(nodes.at(2), nodes.at(3));
+
+  SECTION("Deleting nodes removes their links and keeps order") {
+    size_t kept_id = nodes.at(2)->GetId();
+    network.DeleteNodes({nodes.at(1)->GetId(), nodes.at(3)->GetId(), 100});
+    REQUIRE(network.GetNodes().size() == 2);
+    REQUIRE(network.GetNodes().at(1)->GetId() == kept_id);
+    REQUIRE(network.GetLinks().empty());
+  }
+
+  SECTION("Deleting links by ID") {
+    size_t kept_id = network.GetLinks().at(1).GetId();
+    network.DeleteLinks({network.GetLinks().at(0).GetId(),
+                         network.GetLinks().at(2).GetId(), 100});
+    REQUIRE(network.GetLinks().size() == 1);
+    REQUIRE(network.GetLinks().at(0).GetId() == kept_id);
+    // links can be added again once deleted
+    REQUIRE(network.AddLink(nodes.at(3), nodes.at(0)) != nullptr);
+  }
+
+  SECTION("Deleting nothing") {
+    network.DeleteNodes({});
+    network.DeleteLinks({nodes.at(0)->GetId()});
+    REQUIRE(network.GetNodes().size() == 4);
+    REQUIRE(network.GetLinks().size() == 3);
+  }
+
+}
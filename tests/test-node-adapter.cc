@@ -29,7 +29,7 @@ TEST_CASE("NodeAdapter: Constructor", "[NodeAdapter][Constructor]") {
 }
 
 /*
- * std::vector<NodeAdapter> BuildNodeAdapters(std::deque<Node>& nodes)
+ * std::vector<NodeAdapter> BuildNodeAdapters(const NodeDeque& nodes)
  */
 
 TEST_CASE("NodeAdapter: BuildNodeAdapters",
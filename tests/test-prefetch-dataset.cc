@@ -0,0 +1,56 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/prefetch-dataset.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::PrefetchDataset;
+
+/*
+ * std::vector<af::array> get(int64_t idx) const override;
+ * Counters GetCounters() const;
+ */
+TEST_CASE("PrefetchDataset: get", "[PrefetchDataset][get]") {
+
+  auto values = af::range(af::dim4(1, 10), 1);
+  auto dataset = std::make_shared<fl::TensorDataset>(
+      std::vector<af::array>{values});
+
+  SECTION("Iterating in order serves every sample from the prefetch") {
+    PrefetchDataset prefetch(dataset, 2, 3);
+    REQUIRE(prefetch.size() == 10);
+    for (int64_t i = 0; i < prefetch.size(); ++i) {
+      REQUIRE(prefetch.get(i).at(0).scalar<float>() == Approx(i));
+    }
+    auto counters = prefetch.GetCounters();
+    REQUIRE(counters.requests_ == 10);
+    // only the first sample cannot have been prefetched
+    REQUIRE(counters.misses_ == 1);
+  }
+
+  SECTION("Jumping restarts the prefetch") {
+    PrefetchDataset prefetch(dataset, 2, 3);
+    REQUIRE(prefetch.get(0).at(0).scalar<float>() == Approx(0));
+    REQUIRE(prefetch.get(7).at(0).scalar<float>() == Approx(7));
+    REQUIRE(prefetch.get(8).at(0).scalar<float>() == Approx(8));
+    REQUIRE(prefetch.GetCounters().misses_ == 2);
+
+    prefetch.ResetCounters();
+    REQUIRE(prefetch.GetCounters().requests_ == 0);
+  }
+
+  SECTION("No workers serves every sample synchronously") {
+    PrefetchDataset prefetch(dataset, 0, 3);
+    for (int64_t i = 0; i < prefetch.size(); ++i) {
+      REQUIRE(prefetch.get(i).at(0).scalar<float>() == Approx(i));
+    }
+    REQUIRE(prefetch.GetCounters().requests_ == 10);
+    REQUIRE(prefetch.GetCounters().misses_ == 0);
+  }
+
+  SECTION("Index out of range") {
+    PrefetchDataset prefetch(dataset, 2, 3);
+    REQUIRE_THROWS_AS(prefetch.get(10), std::out_of_range);
+  }
+
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/record-dataset.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using neurons::ElementType;
+using neurons::RecordDataset;
+using neurons::RecordFile;
+
+/*
+ * std::vector<af::array> get(int64_t idx) const override;
+ */
+TEST_CASE("RecordDataset: get", "[RecordDataset][get]") {
+
+  // 5 images of 2 x 3 bytes, each filled with its index, and their labels
+  const std::string inputs_path = "test-record-dataset-inputs.bin";
+  const std::string targets_path = "test-record-dataset-targets.bin";
+  {
+    std::ofstream inputs(inputs_path, std::ios::binary | std::ios::trunc);
+    std::ofstream targets(targets_path, std::ios::binary | std::ios::trunc);
+    for (char i = 0; i < 5; ++i) {
+      inputs << std::string(6, i);
+      targets << i;
+    }
+  }
+  std::shared_ptr<const RecordFile> inputs =
+      RecordFile::OpenRaw(inputs_path, ElementType::UInt8, {2, 3});
+  std::shared_ptr<const RecordFile> targets =
+      RecordFile::OpenRaw(targets_path, ElementType::UInt8, {});
+  RecordDataset dataset(inputs, targets, 2, 1, 0.5f);
+
+  SECTION("Batches are laid out as images") {
+    REQUIRE(dataset.size() == 3);
+    auto batch = dataset.get(1);
+    REQUIRE(batch.at(0).type() == f32);
+    REQUIRE(batch.at(0).dims() == af::dim4(3, 2, 1, 2));
+    REQUIRE(batch.at(0)(0, 0, 0, 1).scalar<float>() == Approx(2.0f));
+    REQUIRE(batch.at(1).type() == s32);
+    REQUIRE(batch.at(1).dims() == af::dim4(2));
+    REQUIRE(batch.at(1)(0).scalar<int>() == 2);
+  }
+
+  SECTION("Last batch holds the remaining examples") {
+    REQUIRE(dataset.get(2).at(1).dims(0) == 1);
+    REQUIRE_THROWS_AS(dataset.get(3), std::out_of_range);
+  }
+
+  SECTION("Example counts do not match") {
+    std::shared_ptr<const RecordFile> fewer =
+        RecordFile::OpenRaw(inputs_path, ElementType::UInt8, {2, 3, 5});
+    REQUIRE_THROWS_AS(RecordDataset(fewer, targets, 2, 0, 1),
+                      std::invalid_argument);
+  }
+
+}
@@ -0,0 +1,175 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/record-source.h>
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <fstream>
+
+using neurons::ElementType;
+using neurons::OpenRecordFile;
+using neurons::RecordFile;
+
+namespace {
+
+// Writes the string to a file at path, replacing any existing file.
+void WriteFile(const std::string& path, const std::string& contents) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+// Returns a version 1 .npy file of the passed header dictionary and data,
+// with the header padded as NumPy does.
+std::string NpyFile(const std::string& dictionary, const std::string& data) {
+  std::string header = dictionary;
+  while ((10 + header.size() + 1) % 64 != 0) {
+    header += ' ';
+  }
+  header += '\n';
+  std::string file = "\x93NUMPY";
+  file += '\x01';
+  file += '\x00';
+  file += static_cast<char>(header.size() & 0xFFu);
+  file += static_cast<char>(header.size() >> 8u);
+  return file + header + data;
+}
+
+}  // namespace
+
+/*
+ * static std::unique_ptr<RecordFile> OpenIdx(const std::string& path);
+ */
+TEST_CASE("RecordFile: OpenIdx", "[RecordFile][OpenIdx]") {
+
+  const std::string path = "test-record-source.idx";
+
+  SECTION("Byte records") {
+    // 3 records of 1 x 2 bytes
+    WriteFile(path, std::string("\0\0\x08\x03", 4) +
+                    std::string("\0\0\0\x03\0\0\0\x01\0\0\0\x02", 12) +
+                    "abcdef");
+    auto file = RecordFile::OpenIdx(path);
+    REQUIRE(file->GetElementType() == ElementType::UInt8);
+    REQUIRE(file->GetRecordShape() == std::vector<size_t>{1, 2});
+    REQUIRE(file->GetRecordCount() == 3);
+    REQUIRE(file->GetRecordSize() == 2);
+
+    std::string records(4, '\0');
+    file->ReadRecords(1, 2, &records[0]);
+    REQUIRE(records == "cdef");
+  }
+
+  SECTION("Big-endian integers are read in native order") {
+    WriteFile(path, std::string("\0\0\x0C\x01\0\0\0\x02", 8) +
+                    std::string("\0\0\x01\x02\xFF\xFF\xFF\xFE", 8));
+    auto file = RecordFile::OpenIdx(path);
+    REQUIRE(file->GetElementType() == ElementType::Int32);
+    REQUIRE(file->GetRecordShape().empty());
+
+    int32_t values[2];
+    file->ReadRecords(0, 2, values);
+    REQUIRE(values[0] == 258);
+    REQUIRE(values[1] == -2);
+  }
+
+  SECTION("Unknown element type") {
+    WriteFile(path, std::string("\0\0\x01\x01\0\0\0\x01\0", 9));
+    REQUIRE_THROWS_AS(RecordFile::OpenIdx(path), std::runtime_error);
+  }
+
+  SECTION("Truncated data") {
+    WriteFile(path, std::string("\0\0\x08\x01\0\0\0\x04\0", 9));
+    REQUIRE_THROWS_AS(RecordFile::OpenIdx(path), std::runtime_error);
+  }
+
+  SECTION("Missing file") {
+    REQUIRE_THROWS_AS(RecordFile::OpenIdx("missing.idx"), std::runtime_error);
+  }
+
+}
+
+/*
+ * static std::unique_ptr<RecordFile> OpenNpy(const std::string& path);
+ */
+TEST_CASE("RecordFile: OpenNpy", "[RecordFile][OpenNpy]") {
+
+  const std::string path = "test-record-source.npy";
+
+  SECTION("Float records") {
+    float values[] = {1.5f, -2, 3, 4, 5, 6};
+    WriteFile(path, NpyFile(
+        "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 2), }",
+        std::string(reinterpret_cast<const char*>(values), sizeof(values))));
+    auto file = OpenRecordFile(path);
+    REQUIRE(file->GetElementType() == ElementType::Float32);
+    REQUIRE(file->GetRecordShape() == std::vector<size_t>{2});
+    REQUIRE(file->GetRecordCount() == 3);
+
+    float records[2];
+    file->ReadRecords(0, 1, records);
+    REQUIRE(records[0] == Approx(1.5f));
+    REQUIRE(records[1] == Approx(-2));
+  }
+
+  SECTION("One-dimensional arrays hold scalar records") {
+    WriteFile(path, NpyFile(
+        "{'descr': '|u1', 'fortran_order': False, 'shape': (4,), }", "wxyz"));
+    auto file = RecordFile::OpenNpy(path);
+    REQUIRE(file->GetRecordShape().empty());
+    REQUIRE(file->GetRecordCount() == 4);
+  }
+
+  SECTION("Fortran order") {
+    WriteFile(path, NpyFile(
+        "{'descr': '|u1', 'fortran_order': True, 'shape': (2, 2), }", "wxyz"));
+    REQUIRE_THROWS_AS(RecordFile::OpenNpy(path), std::runtime_error);
+  }
+
+  SECTION("Unsupported type") {
+    WriteFile(path, NpyFile(
+        "{'descr': '<c8', 'fortran_order': False, 'shape': (1,), }",
+        std::string(8, '\0')));
+    REQUIRE_THROWS_AS(RecordFile::OpenNpy(path), std::runtime_error);
+  }
+
+  SECTION("Not a .npy file") {
+    WriteFile(path, "not numpy");
+    REQUIRE_THROWS_AS(RecordFile::OpenNpy(path), std::runtime_error);
+  }
+
+}
+
+/*
+ * static std::unique_ptr<RecordFile> OpenRaw(const std::string& path,
+ *     ElementType type, const std::vector<size_t>& record_shape,
+ *     size_t header_size = 0);
+ */
+TEST_CASE("RecordFile: OpenRaw", "[RecordFile][OpenRaw]") {
+
+  const std::string path = "test-record-source.bin";
+
+  SECTION("Records after a header") {
+    WriteFile(path, "HDRabcdefghijkl");
+    auto file = RecordFile::OpenRaw(path, ElementType::UInt8, {2, 2}, 3);
+    REQUIRE(file->GetRecordCount() == 3);
+
+    std::string records(4, '\0');
+    file->ReadRecords(2, 1, &records[0]);
+    REQUIRE(records == "ijkl");
+  }
+
+  SECTION("Partial record") {
+    WriteFile(path, "abcde");
+    REQUIRE_THROWS_AS(RecordFile::OpenRaw(path, ElementType::Int16, {1}),
+                      std::runtime_error);
+  }
+
+  SECTION("Records out of range") {
+    WriteFile(path, "abcd");
+    auto file = RecordFile::OpenRaw(path, ElementType::UInt8, {2});
+    std::string records(4, '\0');
+    REQUIRE_THROWS_AS(file->ReadRecords(1, 2, &records[0]),
+                      std::out_of_range);
+  }
+
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/slot-map.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::Handle;
+using neurons::SlotMap;
+
+/*
+ * Handle Insert(T value);
+ * T* Get(const Handle& handle);
+ */
+TEST_CASE("SlotMap: Insert and Get", "[SlotMap][Insert][Get]") {
+
+  SlotMap<int> map;
+
+  SECTION("Empty map") {
+    REQUIRE(map.Size() == 0);
+    REQUIRE(map.Get({0, 0}) == nullptr);
+  }
+
+  SECTION("Inserted values are retrieved by Handle") {
+    Handle first = map.Insert(1);
+    Handle second = map.Insert(2);
+    REQUIRE(map.Size() == 2);
+    REQUIRE(*map.Get(first) == 1);
+    REQUIRE(*map.Get(second) == 2);
+    REQUIRE(map.GetValues() == std::vector<int>{1, 2});
+  }
+
+}
+
+/*
+ * bool Erase(const Handle& handle);
+ */
+TEST_CASE("SlotMap: Erase", "[SlotMap][Erase][Contains]") {
+
+  SlotMap<int> map;
+  Handle first = map.Insert(1);
+  Handle second = map.Insert(2);
+  Handle third = map.Insert(3);
+
+  SECTION("Erased Handles become stale") {
+    REQUIRE(map.Erase(first));
+    REQUIRE_FALSE(map.Contains(first));
+    REQUIRE(map.Get(first) == nullptr);
+    REQUIRE_FALSE(map.Erase(first));
+    REQUIRE(map.Size() == 2);
+  }
+
+  SECTION("Other Handles survive values being moved") {
+    map.Erase(first);
+    REQUIRE(*map.Get(second) == 2);
+    REQUIRE(*map.Get(third) == 3);
+    REQUIRE(map.GetHandle(map.GetPosition(third)) == third);
+  }
+
+  SECTION("Reused slots do not revive stale Handles") {
+    map.Erase(second);
+    Handle fourth = map.Insert(4);
+    REQUIRE(fourth.index_ == second.index_);
+    REQUIRE(fourth != second);
+    REQUIRE(map.Get(second) == nullptr);
+    REQUIRE(*map.Get(fourth) == 4);
+  }
+
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+#include <neurons/synthetic-dataset.h>
+
+#include <catch2/catch.hpp>
+
+using neurons::SyntheticDataset;
+
+/*
+ * SyntheticDataset(const af::dim4& example_dims, int class_count,
+ *                  dim_t example_count, dim_t batch_size, float noise,
+ *                  uint64_t seed);
+ */
+TEST_CASE("SyntheticDataset: Constructor",
+          "[SyntheticDataset][Constructor]") {
+
+  SECTION("Valid arguments") {
+    SyntheticDataset dataset(af::dim4(4, 4), 3, 10, 4, 0.5f, 1);
+    REQUIRE(dataset.GetExampleCount() == 10);
+    REQUIRE(dataset.GetClassCount() == 3);
+    REQUIRE(dataset.size() == 3);
+  }
+
+  SECTION("Examples span dim 3") {
+    REQUIRE_THROWS_AS(SyntheticDataset(af::dim4(4, 4, 1, 2), 3, 10, 4, 0, 1),
+                      std::invalid_argument);
+  }
+
+  SECTION("No classes") {
+    REQUIRE_THROWS_AS(SyntheticDataset(af::dim4(4), 0, 10, 4, 0, 1),
+                      std::invalid_argument);
+  }
+
+  SECTION("Batch size is not positive") {
+    REQUIRE_THROWS_AS(SyntheticDataset(af::dim4(4), 3, 10, 0, 0, 1),
+                      std::invalid_argument);
+  }
+
+}
+
+/*
+ * std::vector<af::array> get(int64_t idx) const override;
+ */
+TEST_CASE("SyntheticDataset: get", "[SyntheticDataset][get]") {
+
+  SyntheticDataset dataset(af::dim4(3, 2), 4, 10, 4, 0.5f, 7);
+
+  SECTION("Batches have the example dims and labels in range") {
+    auto batch = dataset.get(0);
+    REQUIRE(batch.at(0).type() == f32);
+    REQUIRE(batch.at(0).dims() == af::dim4(3, 2, 1, 4));
+    REQUIRE(batch.at(1).type() == s32);
+    REQUIRE(batch.at(1).dims() == af::dim4(4));
+    REQUIRE(af::allTrue<bool>(batch.at(1) >= 0 && batch.at(1) < 4));
+  }
+
+  SECTION("Last batch holds the remaining examples") {
+    REQUIRE(dataset.get(2).at(0).dims(3) == 2);
+    REQUIRE_THROWS_AS(dataset.get(3), std::out_of_range);
+  }
+
+  SECTION("Same seed gives the same batches") {
+    SyntheticDataset same(af::dim4(3, 2), 4, 10, 4, 0.5f, 7);
+    REQUIRE(af::allTrue<bool>(same.get(1).at(0) == dataset.get(1).at(0)));
+    REQUIRE(af::allTrue<bool>(same.get(1).at(1) == dataset.get(1).at(1)));
+  }
+
+  SECTION("Noiseless examples are their class prototype") {
+    SyntheticDataset exact(af::dim4(3, 2), 1, 10, 4, 0, 7);
+    auto inputs = exact.get(0).at(0);
+    REQUIRE(af::allTrue<bool>(inputs(af::span, af::span, af::span, 0) ==
+                              inputs(af::span, af::span, af::span, 3)));
+  }
+
+  SECTION("Splits share the prototypes") {
+    SyntheticDataset exact(af::dim4(3, 2), 1, 10, 4, 0, 7);
+    SyntheticDataset split(exact, 5, 8);
+    REQUIRE(split.GetExampleCount() == 5);
+    REQUIRE(af::allTrue<bool>(split.get(0).at(0)(af::span, af::span,
+        af::span, 0) == exact.get(0).at(0)(af::span, af::span, af::span, 0)));
+  }
+
+}
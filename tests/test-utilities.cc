@@ -9,11 +9,18 @@ using neurons::Node;
 using neurons::DataNode;
 using neurons::ModuleNode;
 using neurons::utilities::AreNodeInputsSatisfied;
+using neurons::utilities::AdjacencyList;
 using neurons::utilities::AreNodeOutputsSatisfied;
+using neurons::utilities::BuildAdjacencyList;
 using neurons::utilities::ContainsDirectedCycle;
 using neurons::utilities::CountConnectedComponents;
 using neurons::utilities::NodesAndLinksConsistent;
+using neurons::utilities::StrongComponents;
+using neurons::utilities::GraphViolation;
+using neurons::utilities::GraphViolationToString;
+using neurons::utilities::TopologicalOrder;
 using neurons::utilities::TopologicalSort;
+using neurons::utilities::ValidateGraph;
 
 /*
  * bool NodesAndLinksConsistent(const NodeDeque& nodes,
@@ -197,6 +204,115 @@ TEST_CASE("Utilities: TopologicalSort",
 
 }
 
+/*
+ * AdjacencyList BuildAdjacencyList(const NodeDeque& nodes,
+    const std::deque<Link>& links, bool reverse = false);
+ */
+TEST_CASE("Utilities: BuildAdjacencyList",
+    "[Utilities][BuildAdjacencyList]") {
+
+  auto node_one = std::make_shared<ModuleNode>(0, neurons::Conv2D,
+      std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+  auto node_two = std::make_shared<ModuleNode>(1, neurons::Conv2D,
+      std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+  auto node_three = std::make_shared<ModuleNode>(2, neurons::Conv2D,
+      std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+  const neurons::NodeDeque nodes = {node_one, node_two, node_three};
+
+  std::deque<Link> links;
+  links.emplace_back(3, node_one, node_three);
+  links.emplace_back(4, node_three, node_two);
+  links.emplace_back(5, node_one, node_two);
+
+  SECTION("No nodes or links") {
+    auto adjacency = BuildAdjacencyList(neurons::NodeDeque(),
+                                        std::deque<Link>());
+    REQUIRE(adjacency.NodeCount() == 0);
+    REQUIRE(adjacency.targets_.empty());
+  }
+
+  SECTION("Forward edges in link order") {
+    auto adjacency = BuildAdjacencyList(nodes, links);
+    REQUIRE(adjacency.NodeCount() == 3);
+    REQUIRE(adjacency.offsets_ == std::vector<size_t>{0, 2, 2, 3});
+    REQUIRE(adjacency.targets_ == std::vector<size_t>{2, 1, 1});
+    REQUIRE(adjacency.links_ == std::vector<size_t>{0, 2, 1});
+  }
+
+  SECTION("Reverse edges in link order") {
+    auto adjacency = BuildAdjacencyList(nodes, links, true);
+    REQUIRE(adjacency.offsets_ == std::vector<size_t>{0, 0, 2, 3});
+    REQUIRE(adjacency.targets_ == std::vector<size_t>{2, 0, 0});
+    REQUIRE(adjacency.links_ == std::vector<size_t>{1, 2, 0});
+  }
+
+  SECTION("Links with a foreign node are skipped") {
+    auto foreign = std::make_shared<ModuleNode>(6, neurons::Conv2D,
+        std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+    links.emplace_back(7, node_two, foreign);
+    links.emplace_back(8, node_two, nullptr);
+    auto adjacency = BuildAdjacencyList(nodes, links);
+    REQUIRE(adjacency.targets_.size() == 3);
+  }
+}
+
+/*
+ * std::vector<size_t> TopologicalOrder(const AdjacencyList& adjacency);
+ */
+TEST_CASE("Utilities: TopologicalOrder", "[Utilities][TopologicalOrder]") {
+
+  SECTION("No nodes") {
+    REQUIRE(TopologicalOrder(AdjacencyList()).empty());
+  }
+
+  SECTION("Diamond is ordered depth-first in link order") {
+    // 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3
+    AdjacencyList adjacency = {{0, 2, 3, 4, 4}, {1, 2, 3, 3}, {0, 1, 2, 3}};
+    REQUIRE(TopologicalOrder(adjacency) == std::vector<size_t>{0, 2, 1, 3});
+  }
+
+  SECTION("Deep chain does not overflow the stack") {
+    const size_t length = 1000000;
+    AdjacencyList adjacency;
+    for (size_t node = 0; node < length; ++node) {
+      adjacency.offsets_.push_back(node);
+    }
+    adjacency.offsets_.push_back(length - 1);
+    for (size_t node = 1; node < length; ++node) {
+      adjacency.targets_.push_back(node);
+      adjacency.links_.push_back(node - 1);
+    }
+
+    auto order = TopologicalOrder(adjacency);
+    REQUIRE(order.size() == length);
+    REQUIRE(order.front() == 0);
+    REQUIRE(order.back() == length - 1);
+  }
+}
+
+/*
+ * std::vector<size_t> StrongComponents(const AdjacencyList& adjacency,
+                                     const AdjacencyList& reverse);
+ */
+TEST_CASE("Utilities: StrongComponents", "[Utilities][StrongComponents]") {
+
+  SECTION("Acyclic graph has a component per node") {
+    // 0 -> 1 -> 2
+    AdjacencyList adjacency = {{0, 1, 2, 2}, {1, 2}, {0, 1}};
+    AdjacencyList reverse = {{0, 0, 1, 2}, {0, 1}, {0, 1}};
+    REQUIRE(StrongComponents(adjacency, reverse) ==
+            std::vector<size_t>{0, 1, 2});
+  }
+
+  SECTION("Cycle nodes share a component") {
+    // 0 -> 1 -> 2 -> 1, 2 -> 3
+    AdjacencyList adjacency = {{0, 1, 2, 4, 4}, {1, 2, 1, 3}, {0, 1, 2, 3}};
+    AdjacencyList reverse = {{0, 0, 2, 3, 4}, {0, 2, 1, 2}, {0, 2, 1, 3}};
+    REQUIRE(StrongComponents(adjacency, reverse) ==
+            std::vector<size_t>{0, 1, 1, 2});
+  }
+}
+
 /*
  * bool ContainsDirectedCycle(const std::deque<Link>& links);
  */
@@ -489,4 +605,137 @@ TEST_CASE("Utilities: AreNodeOutputsSatisfied",
     REQUIRE_FALSE(AreNodeOutputsSatisfied(nodes, links));
   }
 
-}
\ No newline at end of file
+}
+
+/*
+ * std::string GraphViolationToString(const GraphViolation& violation);
+ */
+TEST_CASE("Utilities: GraphViolationToString",
+    "[Utilities][GraphViolationToString]") {
+
+  SECTION("Violation without IDs") {
+    GraphViolation violation = {neurons::utilities::MultipleComponents, {}, {}};
+    REQUIRE(GraphViolationToString(violation) ==
+            "Graph does not consist of 1 component.");
+  }
+
+  SECTION("Violation with node and link IDs") {
+    GraphViolation violation =
+        {neurons::utilities::DirectedCycle, {1, 2}, {3, 4}};
+    REQUIRE(GraphViolationToString(violation) ==
+            "Graph contains a directed cycle. Nodes: 1 2. Links: 3 4.");
+  }
+}
+
+/*
+ * std::vector<GraphViolation> ValidateGraph(const NodeDeque& nodes,
+                                          const std::deque<Link>& links);
+ */
+TEST_CASE("Utilities: ValidateGraph", "[Utilities][ValidateGraph]") {
+
+  auto node_one = std::make_shared<DataNode>(0, nullptr, nullptr, nullptr);
+  auto node_two = std::make_shared<ModuleNode>(1, neurons::Conv2D,
+      std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+  auto node_three = std::make_shared<ModuleNode>(2, neurons::Conv2D,
+      std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+  auto node_four = std::make_shared<ModuleNode>(3,
+      neurons::CategoricalCrossEntropy,
+      std::make_unique<fl::CategoricalCrossEntropy>());
+
+  SECTION("No nodes or links") {
+    auto violations = ValidateGraph(neurons::NodeDeque(), std::deque<Link>());
+    REQUIRE(violations.size() == 1);
+    REQUIRE(violations.at(0).type_ == neurons::utilities::MultipleComponents);
+  }
+
+  SECTION("Valid graph") {
+    neurons::NodeDeque nodes = {node_one, node_two, node_three, node_four};
+    std::deque<Link> links;
+    links.emplace_back(4, node_one, node_two);
+    links.emplace_back(5, node_two, node_three);
+    links.emplace_back(6, node_one, node_three);
+    links.emplace_back(7, node_three, node_four);
+    REQUIRE(ValidateGraph(nodes, links).empty());
+  }
+
+  SECTION("Inconsistent nodes and links") {
+    auto foreign = std::make_shared<ModuleNode>(8, neurons::Conv2D,
+        std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+    neurons::NodeDeque nodes = {node_one, node_two, node_four};
+    std::deque<Link> links;
+    links.emplace_back(4, node_one, node_two);
+    links.emplace_back(4, node_two, node_four);
+    links.emplace_back(5, node_two, foreign);
+
+    auto violations = ValidateGraph(nodes, links);
+    REQUIRE(violations.size() == 2);
+    REQUIRE(violations.at(0).type_ == neurons::utilities::DuplicateId);
+    REQUIRE(violations.at(0).link_ids_ == std::vector<size_t>{4});
+    REQUIRE(violations.at(1).type_ == neurons::utilities::ForeignNode);
+    REQUIRE(violations.at(1).node_ids_ == std::vector<size_t>{8});
+    REQUIRE(violations.at(1).link_ids_ == std::vector<size_t>{5});
+  }
+
+  SECTION("Directed cycle only reports nodes on the cycle") {
+    neurons::NodeDeque nodes = {node_one, node_two, node_three, node_four};
+    std::deque<Link> links;
+    links.emplace_back(4, node_one, node_two);
+    links.emplace_back(5, node_two, node_three);
+    links.emplace_back(6, node_three, node_two);
+    links.emplace_back(7, node_three, node_four);
+
+    auto violations = ValidateGraph(nodes, links);
+    REQUIRE(violations.size() == 1);
+    REQUIRE(violations.at(0).type_ == neurons::utilities::DirectedCycle);
+    REQUIRE(violations.at(0).node_ids_ == std::vector<size_t>{1, 2});
+    REQUIRE(violations.at(0).link_ids_ == std::vector<size_t>{5, 6});
+  }
+
+  SECTION("Separate directed cycles are reported separately") {
+    auto node_five = std::make_shared<ModuleNode>(9, neurons::Conv2D,
+        std::make_unique<fl::Conv2D>(fl::Conv2D(1, 1, 1, 1)));
+    neurons::NodeDeque nodes =
+        {node_one, node_two, node_three, node_four, node_five};
+    std::deque<Link> links;
+    links.emplace_back(4, node_one, node_two);
+    links.emplace_back(5, node_two, node_one);
+    links.emplace_back(6, node_two, node_three);
+    links.emplace_back(7, node_three, node_five);
+    links.emplace_back(8, node_five, node_three);
+    links.emplace_back(10, node_five, node_four);
+
+    auto violations = ValidateGraph(nodes, links);
+    REQUIRE(violations.size() == 2);
+    REQUIRE(violations.at(0).type_ == neurons::utilities::DirectedCycle);
+    REQUIRE(violations.at(0).node_ids_ == std::vector<size_t>{0, 1});
+    REQUIRE(violations.at(0).link_ids_ == std::vector<size_t>{4, 5});
+    REQUIRE(violations.at(1).type_ == neurons::utilities::DirectedCycle);
+    REQUIRE(violations.at(1).node_ids_ == std::vector<size_t>{2, 9});
+    REQUIRE(violations.at(1).link_ids_ == std::vector<size_t>{7, 8});
+  }
+
+  SECTION("Reports every violation") {
+    neurons::NodeDeque nodes = {node_one, node_two, node_three, node_four};
+    std::deque<Link> links;
+    links.emplace_back(4, node_one, node_two);
+    links.emplace_back(5, node_three, node_three);
+
+    auto violations = ValidateGraph(nodes, links);
+    REQUIRE(violations.size() == 7);
+    // components: {0, 1}, {2}, {3}
+    REQUIRE(violations.at(0).type_ == neurons::utilities::MultipleComponents);
+    REQUIRE(violations.at(0).node_ids_ == std::vector<size_t>{0, 1});
+    REQUIRE(violations.at(1).node_ids_ == std::vector<size_t>{2});
+    REQUIRE(violations.at(2).node_ids_ == std::vector<size_t>{3});
+    // node_three cannot satisfy its own input, node_four has no input
+    REQUIRE(violations.at(3).type_ == neurons::utilities::UnsatisfiedInput);
+    REQUIRE(violations.at(3).node_ids_ == std::vector<size_t>{2});
+    REQUIRE(violations.at(4).type_ == neurons::utilities::UnsatisfiedInput);
+    REQUIRE(violations.at(4).node_ids_ == std::vector<size_t>{3});
+    // node_two and node_three have no output
+    REQUIRE(violations.at(5).type_ == neurons::utilities::UnsatisfiedOutput);
+    REQUIRE(violations.at(5).node_ids_ == std::vector<size_t>{1});
+    REQUIRE(violations.at(6).type_ == neurons::utilities::UnsatisfiedOutput);
+    REQUIRE(violations.at(6).node_ids_ == std::vector<size_t>{2});
+  }
+}
@@ -0,0 +1,18 @@
+# Two-layer perceptron for MNIST, e.g.
+#   neurons-trainer trainer/mnist-mlp.spec assets/mnist --epochs 5
+node flatten View 784 -1 1 1
+node hidden Linear 784 128 1
+node activation ReLU
+node output Linear 128 10 1
+node log_softmax LogSoftmax
+node loss CategoricalCrossEntropy
+
+link data flatten
+link flatten hidden
+link hidden activation
+link activation output
+link output log_softmax
+link log_softmax loss
+
+# learning rate, momentum, weight decay, use nesterov
+optimizer SGDOptimizer 0.1 0 0 0
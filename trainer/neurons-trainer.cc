@@ -0,0 +1,344 @@
+// Copyright (c) 2020 Simon Liu. All rights reserved.
+
+// Trains a network without the editor, for batch jobs on machines without
+// a display.
+// Usage: neurons-trainer <spec> <data_dir>
+//            [--data-format mnist|records|raw] [--input-type T]
+//            [--input-shape DxD...] [--target-type T]
+//            [--input-offset X] [--input-scale X] [--epochs N]
+//            [--batch-size N] [--readback-interval N] [--checkpoint PATH]
+//            [--metrics PATH] [--augment]
+//        neurons-trainer <spec> --synthetic N [options]
+//
+// spec is a network spec file, see neurons/network-spec.h. data_dir holds
+// the MNIST IDX files, or for records the files train-inputs,
+// train-targets, valid-inputs, valid-targets, test-inputs and test-targets,
+// each with a .npy or .idx extension. For raw, the same files have a .bin
+// extension and no header: each holds native byte order records of the
+// input or target type, one of u8, i8, i16, i32, i64, f32 and f64 (u8 by
+// default). Raw input records have the shape --input-shape, such as 28x28,
+// and raw targets are single class indices. Record inputs are normalized to
+// (element + input offset) * input scale. --augment randomly distorts the
+// MNIST train images every epoch. With --synthetic N, no data_dir
+// is passed and the network trains on N generated MNIST-shaped examples,
+// which times the device without any disk I/O. The parameters
+// are saved to the checkpoint path after every epoch, and the train,
+// validation and test metrics are written to the metrics path as CSV.
+// Exits with one of the statuses below.
+
+#include <mnist-utilities.h>
+#include <neurons/network-spec.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace neurons::trainer {
+
+enum ExitStatus {
+  kSuccess = 0,
+  kUsageError = 1,
+  kInvalidNetwork = 2,
+  kDataError = 3,
+  kTrainingError = 4
+};
+
+const int kDefaultEpochs = 5;
+const dim_t kDefaultBatchSize = 64;
+const size_t kPrefetchThreads = 2;
+const size_t kPrefetchDepth = 4;
+// Seed of the synthetic examples, fixed so runs are comparable
+const uint64_t kSyntheticSeed = 128;
+const int kSyntheticClassCount = 10;
+
+// Sources of the training data.
+enum DataFormat {
+  kMnist,
+  kRecords,
+  kRaw,
+  kSynthetic
+};
+
+struct Options {
+  std::string spec_path_;
+  std::string data_dir_;
+  DataFormat data_format_ = kMnist;
+  // Element types and input record shape, for kRaw
+  ElementType input_type_ = ElementType::UInt8;
+  std::vector<size_t> input_shape_;
+  ElementType target_type_ = ElementType::UInt8;
+  float input_offset_ = 0;
+  float input_scale_ = 1;
+  // Number of generated train examples, for kSynthetic
+  dim_t synthetic_size_ = 0;
+  int epochs_ = kDefaultEpochs;
+  dim_t batch_size_ = kDefaultBatchSize;
+  // Whether the MNIST train set is augmented
+  bool augment_ = false;
+  int readback_interval_ = mnist_utilities::kLossReadbackInterval;
+  std::string checkpoint_path_;
+  std::string metrics_path_;
+};
+
+// Parse an element type name such as u8. Throws std::invalid_argument if it
+// names none.
+ElementType ParseElementType(const std::string& name) {
+  const std::vector<std::pair<std::string, ElementType>> types = {
+      {"u8", ElementType::UInt8}, {"i8", ElementType::Int8},
+      {"i16", ElementType::Int16}, {"i32", ElementType::Int32},
+      {"i64", ElementType::Int64}, {"f32", ElementType::Float32},
+      {"f64", ElementType::Float64}};
+  for (const auto& type : types) {
+    if (type.first == name) {
+      return type.second;
+    }
+  }
+  throw std::invalid_argument("Unknown element type " + name);
+}
+
+// Parse a record shape such as 28x28. Throws std::invalid_argument if it
+// is malformed.
+std::vector<size_t> ParseShape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::istringstream dims(text);
+  std::string dim;
+  while (std::getline(dims, dim, 'x')) {
+    if (dim.empty() || dim.find_first_not_of("0123456789") !=
+                       std::string::npos || std::stoull(dim) == 0) {
+      throw std::invalid_argument("Invalid record shape " + text);
+    }
+    shape.push_back(std::stoull(dim));
+  }
+  // getline drops a trailing empty dim
+  if (shape.empty() || text.back() == 'x') {
+    throw std::invalid_argument("Invalid record shape " + text);
+  }
+  return shape;
+}
+
+// Parse the command line into options. Throws std::invalid_argument if it
+// is malformed.
+Options ParseOptions(int argc, char** argv) {
+  Options options;
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--", 0) != 0) {
+      if (positional == 0) {
+        options.spec_path_ = arg;
+      } else if (positional == 1) {
+        options.data_dir_ = arg;
+      } else {
+        throw std::invalid_argument("Unexpected argument " + arg);
+      }
+      ++positional;
+      continue;
+    }
+    // the only option without a value
+    if (arg == "--augment") {
+      options.augment_ = true;
+      continue;
+    }
+    if (i + 1 == argc) {
+      throw std::invalid_argument(arg + " needs a value");
+    }
+    std::string value = argv[++i];
+    if (arg == "--data-format") {
+      if (value == "mnist") {
+        options.data_format_ = kMnist;
+      } else if (value == "records") {
+        options.data_format_ = kRecords;
+      } else if (value == "raw") {
+        options.data_format_ = kRaw;
+      } else {
+        throw std::invalid_argument("Unknown data format " + value);
+      }
+    } else if (arg == "--synthetic") {
+      options.data_format_ = kSynthetic;
+      options.synthetic_size_ = std::stoll(value);
+    } else if (arg == "--input-type") {
+      options.input_type_ = ParseElementType(value);
+    } else if (arg == "--input-shape") {
+      options.input_shape_ = ParseShape(value);
+    } else if (arg == "--target-type") {
+      options.target_type_ = ParseElementType(value);
+    } else if (arg == "--input-offset") {
+      options.input_offset_ = std::stof(value);
+    } else if (arg == "--input-scale") {
+      options.input_scale_ = std::stof(value);
+    } else if (arg == "--epochs") {
+      options.epochs_ = std::stoi(value);
+    } else if (arg == "--batch-size") {
+      options.batch_size_ = std::stoll(value);
+    } else if (arg == "--readback-interval") {
+      options.readback_interval_ = std::stoi(value);
+    } else if (arg == "--checkpoint") {
+      options.checkpoint_path_ = value;
+    } else if (arg == "--metrics") {
+      options.metrics_path_ = value;
+    } else {
+      throw std::invalid_argument("Unknown option " + arg);
+    }
+  }
+  // synthetic data has no data directory
+  int expected_positional = options.data_format_ == kSynthetic ? 1 : 2;
+  if (positional != expected_positional || options.epochs_ <= 0 ||
+      options.batch_size_ <= 0 ||
+      (options.data_format_ == kSynthetic && options.synthetic_size_ <= 0) ||
+      (options.augment_ && options.data_format_ != kMnist) ||
+      (options.data_format_ == kRaw && options.input_shape_.empty()) ||
+      options.readback_interval_ < 0) {
+    throw std::invalid_argument("Invalid arguments");
+  }
+  return options;
+}
+
+// Get the path of the record file named name in dir, which is the .npy
+// file if there is one and the .idx file otherwise.
+std::string FindRecordFile(const std::string& dir, const std::string& name) {
+  std::string npy = dir + "/" + name + ".npy";
+  return std::ifstream(npy).good() ? npy : dir + "/" + name + ".idx";
+}
+
+// Add the DataNode serving the data of options to network. Throws if the
+// data cannot be loaded.
+void AddDataNode(const Options& options, Network& network) {
+  if (options.data_format_ == kSynthetic) {
+    // evaluate on a fifth as many examples, as MNIST roughly does
+    dim_t eval_size = std::max<dim_t>(options.synthetic_size_ / 5, 1);
+    mnist_utilities::add_synthetic_data_node(network,
+        af::dim4(mnist_utilities::kImDim, mnist_utilities::kImDim, 1),
+        kSyntheticClassCount, options.synthetic_size_, eval_size,
+        options.batch_size_, kSyntheticSeed);
+    return;
+  }
+  if (options.data_format_ == kRecords) {
+    auto files = [&options](const std::string& split) {
+      return mnist_utilities::RecordFiles{
+          FindRecordFile(options.data_dir_, split + "-inputs"),
+          FindRecordFile(options.data_dir_, split + "-targets")};
+    };
+    mnist_utilities::add_record_data_node(network, files("train"),
+        files("valid"), files("test"), options.batch_size_,
+        options.input_offset_, options.input_scale_, kPrefetchThreads,
+        kPrefetchDepth);
+    return;
+  }
+  if (options.data_format_ == kRaw) {
+    auto files = [&options](const std::string& split) {
+      return mnist_utilities::RecordFiles{
+          options.data_dir_ + "/" + split + "-inputs.bin",
+          options.data_dir_ + "/" + split + "-targets.bin"};
+    };
+    // targets are single class indices
+    mnist_utilities::RawRecordLayout layout{options.input_type_,
+        options.input_shape_, options.target_type_, {}};
+    mnist_utilities::add_raw_record_data_node(network, files("train"),
+        files("valid"), files("test"), layout, options.batch_size_,
+        options.input_offset_, options.input_scale_, kPrefetchThreads,
+        kPrefetchDepth);
+    return;
+  }
+  auto splits = mnist_utilities::load_splits(options.data_dir_);
+  mnist_utilities::add_data_node(network, splits, options.batch_size_,
+                                 kPrefetchThreads, kPrefetchDepth,
+                                 options.augment_);
+}
+
+}  // namespace neurons::trainer
+
+int main(int argc, char** argv) {
+  using namespace neurons;
+  using namespace neurons::trainer;
+
+  Options options;
+  try {
+    options = ParseOptions(argc, argv);
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl
+              << "Usage: " << argv[0] << " <spec> <data_dir>"
+              << " [--data-format mnist|records|raw] [--input-type T]"
+              << " [--input-shape DxD...] [--target-type T]"
+              << " [--input-offset X] [--input-scale X] [--epochs N]"
+              << " [--batch-size N] [--readback-interval N]"
+              << " [--checkpoint PATH] [--metrics PATH] [--augment]"
+              << std::endl
+              << "       " << argv[0] << " <spec> --synthetic N [options]"
+              << std::endl;
+    return kUsageError;
+  }
+
+  std::ofstream metrics;
+  if (!options.metrics_path_.empty()) {
+    metrics.open(options.metrics_path_);
+    if (!metrics) {
+      std::cerr << "Can't write metrics to " << options.metrics_path_
+                << std::endl;
+      return kUsageError;
+    }
+    metrics << "split,epoch,loss,error" << std::endl;
+  }
+
+  NetworkSpec spec;
+  try {
+    spec = LoadNetworkSpec(options.spec_path_);
+  } catch (const std::exception& exception) {
+    std::cerr << "Invalid network spec: " << exception.what() << std::endl;
+    return kInvalidNetwork;
+  }
+
+  Network network;
+  try {
+    AddDataNode(options, network);
+  } catch (const std::exception& exception) {
+    std::cerr << "Failed to load data: " << exception.what() << std::endl;
+    return kDataError;
+  }
+
+  std::unique_ptr<NetworkContainer> model;
+  std::shared_ptr<fl::FirstOrderOptimizer> optimizer;
+  try {
+    BuildNetwork(spec, network);
+    model = std::make_unique<NetworkContainer>(*network.GetSnapshot());
+    optimizer = MakeOptimizer(spec.optimizer_, model->params());
+  } catch (const std::exception& exception) {
+    std::cerr << "Invalid network: " << exception.what() << std::endl;
+    return kInvalidNetwork;
+  }
+
+  mnist_utilities::TrainCallbacks callbacks;
+  callbacks.on_epoch_ = [&](int epoch, double train_loss,
+      const ClassificationMetrics::Results& validation) {
+    if (metrics.is_open()) {
+      metrics << "train," << epoch << "," << train_loss << "," << std::endl
+              << "validation," << epoch << "," << validation.loss_ << ","
+              << validation.error_ << std::endl;
+    }
+    if (!options.checkpoint_path_.empty()) {
+      fl::save(options.checkpoint_path_, model->params());
+    }
+  };
+  callbacks.on_test_ = [&](const ClassificationMetrics::Results& test) {
+    if (metrics.is_open()) {
+      metrics << "test,," << test.loss_ << "," << test.error_ << std::endl;
+    }
+  };
+
+  bool training = false;
+  std::exception_ptr exception_ptr = nullptr;
+  mnist_utilities::train_model(*model, *network.GetDataNode(), *optimizer,
+      options.epochs_, options.readback_interval_, std::cout, training,
+      exception_ptr, callbacks);
+  if (exception_ptr != nullptr) {
+    try {
+      std::rethrow_exception(exception_ptr);
+    } catch (const std::exception& exception) {
+      std::cerr << "Training failed: " << exception.what() << std::endl;
+    }
+    return kTrainingError;
+  }
+  return kSuccess;
+}